@@ -0,0 +1,96 @@
+// ex1 与 ex2 共用的光照计算，由片段着色器 #include，不单独编译。
+//
+// 特性宏（由 ShaderVariants 按位掩码定义，每种组合编译为独立的程序）：
+//   EMISSIVE    自发光（太阳），直接输出基础颜色
+//   TEXTURED    基础颜色取纹理颜色（自发光时再乘以 objectColor）
+//   BACK_LIGHT  第二个较弱的背光源
+// 光照参数宏未定义时使用下面的默认值（ex2 的取值），ex1 通过 addDefine 覆盖。
+
+#ifndef AMBIENT_STRENGTH
+#define AMBIENT_STRENGTH 0.15
+#endif
+#ifndef AMBIENT_COLOR
+#define AMBIENT_COLOR vec3(1.0, 1.0, 0.95)
+#endif
+#ifndef DIFFUSE_COLOR
+#define DIFFUSE_COLOR vec3(1.8, 1.8, 1.7)
+#endif
+#ifndef SPECULAR_STRENGTH
+#define SPECULAR_STRENGTH 0.4
+#endif
+#ifndef SPECULAR_COLOR
+#define SPECULAR_COLOR vec3(1.0, 1.0, 0.95)
+#endif
+#ifndef ATTENUATION_LINEAR
+#define ATTENUATION_LINEAR 0.003
+#endif
+#ifndef ATTENUATION_QUADRATIC
+#define ATTENUATION_QUADRATIC 0.00005
+#endif
+
+uniform vec3 objectColor;
+uniform vec3 viewPos;
+#ifndef EMISSIVE
+uniform vec3 sunLightPos;      // 太阳主光源位置
+#ifdef BACK_LIGHT
+uniform vec3 backLightPos;     // 太阳背光位置
+#endif
+#endif
+
+// 输入为世界空间位置、法线和纹理颜色（未定义 TEXTURED 时忽略），返回最终颜色
+vec3 shade(vec3 fragPos, vec3 normal, vec3 texColor)
+{
+#ifdef EMISSIVE
+    // 太阳自发光
+#ifdef TEXTURED
+    return texColor * objectColor;
+#else
+    return objectColor;
+#endif
+#else
+    // 获取基础颜色
+#ifdef TEXTURED
+    vec3 baseColor = texColor;
+#else
+    vec3 baseColor = objectColor;
+#endif
+
+    // 环境光
+    vec3 ambient = AMBIENT_STRENGTH * AMBIENT_COLOR;
+
+    // === 主光源（来自太阳） ===
+    vec3 norm = normalize(normal);
+    vec3 sunLightDir = normalize(sunLightPos - fragPos);
+
+    // 漫反射
+    float sunDiff = max(dot(norm, sunLightDir), 0.0);
+    vec3 sunDiffuse = sunDiff * DIFFUSE_COLOR;
+
+    // 镜面反射
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 reflectDir = reflect(-sunLightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 sunSpecular = SPECULAR_STRENGTH * spec * SPECULAR_COLOR;
+
+    // 距离衰减
+    float distance = length(sunLightPos - fragPos);
+    float attenuation = 1.0 / (1.0 + ATTENUATION_LINEAR * distance + ATTENUATION_QUADRATIC * distance * distance);
+
+    vec3 result = ambient + (sunDiffuse + sunSpecular) * attenuation;
+
+#ifdef BACK_LIGHT
+    // === 背光（专门照亮太阳） ===
+    vec3 backLightDir = normalize(backLightPos - fragPos);
+    float backDiff = max(dot(norm, backLightDir), 0.0);
+    vec3 backDiffuse = backDiff * vec3(0.3, 0.3, 0.3); // 较弱的背光
+
+    float backDistance = length(backLightPos - fragPos);
+    float backAttenuation = 1.0 / (1.0 + 0.005 * backDistance + 0.0001 * backDistance * backDistance);
+
+    result += backDiffuse * backAttenuation;
+#endif
+
+    // 合成最终颜色
+    return result * baseColor;
+#endif
+}
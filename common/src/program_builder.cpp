@@ -0,0 +1,201 @@
+#include "program_builder.h"
+
+#include "program_cache.h"
+
+#include <cstring>
+#include <iostream>
+
+// glad 只生成了 OpenGL 3.3 Core，并行编译扩展的入口在这里按需加载（KHR 与 ARB 版本的枚举值相同）
+#ifndef GL_KHR_parallel_shader_compile
+#define GL_COMPLETION_STATUS_KHR            0x91B1
+
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+namespace
+{
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glext_MaxShaderCompilerThreadsKHR = NULL;
+}
+
+#define glMaxShaderCompilerThreadsKHR glext_MaxShaderCompilerThreadsKHR
+#endif
+
+namespace
+{
+    bool hasExtension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            if (ext && strcmp(ext, name) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    const char* stageName(unsigned int type)
+    {
+        return type == GL_VERTEX_SHADER ? "VERTEX" : type == GL_FRAGMENT_SHADER ? "FRAGMENT" : "COMPUTE";
+    }
+}
+
+ProgramBuilder::ProgramBuilder()
+    : pending(0), parallelCompile(false)
+{
+}
+
+ProgramBuilder::~ProgramBuilder()
+{
+    release();
+}
+
+bool ProgramBuilder::init(GLADloadproc load)
+{
+#ifndef GL_KHR_parallel_shader_compile
+    if (hasExtension("GL_KHR_parallel_shader_compile"))
+        glext_MaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsKHR");
+    else if (hasExtension("GL_ARB_parallel_shader_compile"))
+        glext_MaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsARB");
+#else
+    (void)load;
+#endif
+    parallelCompile = glMaxShaderCompilerThreadsKHR != NULL;
+    // 0xFFFFFFFF 表示线程数由驱动决定
+    if (parallelCompile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    return parallelCompile;
+}
+
+int ProgramBuilder::submit(const std::vector<ShaderStage>& stages)
+{
+    Entry entry;
+    entry.program = 0;
+    entry.done = false;
+
+    if (programBinaryCache.enabled())
+    {
+        std::vector<std::pair<unsigned int, std::string> > sources;
+        for (const ShaderStage& stage : stages)
+            sources.push_back(std::make_pair(stage.type, stage.source));
+        entry.cacheKey = programBinaryCache.makeKey(sources);
+        entry.program = programBinaryCache.load(entry.cacheKey);
+        if (entry.program)
+        {
+            entry.cacheKey.clear();
+            entry.done = true;
+            entries.push_back(entry);
+            return (int)entries.size() - 1;
+        }
+    }
+
+    // 只发出命令，编译结果等到 finish 时再取
+    entry.program = glCreateProgram();
+    for (const ShaderStage& stage : stages)
+    {
+        const char* code = stage.source.c_str();
+        unsigned int shader = glCreateShader(stage.type);
+        glShaderSource(shader, 1, &code, NULL);
+        glCompileShader(shader);
+        glAttachShader(entry.program, shader);
+        entry.shaders.push_back(shader);
+    }
+    programBinaryCache.prepare(entry.program);
+    glLinkProgram(entry.program);
+
+    entry.stages = stages;
+    for (ShaderStage& stage : entry.stages)
+        stage.source.clear();
+    entries.push_back(entry);
+    pending++;
+    return (int)entries.size() - 1;
+}
+
+void ProgramBuilder::finish(Entry& entry)
+{
+    int success;
+    char infoLog[512];
+    glGetProgramiv(entry.program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        // 链接失败时才逐个查看编译状态，定位出错的阶段
+        for (size_t i = 0; i < entry.shaders.size(); i++)
+        {
+            glGetShaderiv(entry.shaders[i], GL_COMPILE_STATUS, &success);
+            if (!success)
+            {
+                glGetShaderInfoLog(entry.shaders[i], 512, NULL, infoLog);
+                std::cout << "ERROR::SHADER::" << stageName(entry.stages[i].type)
+                          << "::COMPILATION_FAILED " << entry.stages[i].path << "\n" << infoLog << std::endl;
+            }
+        }
+        glGetProgramInfoLog(entry.program, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED " << entry.stages.back().path << "\n" << infoLog << std::endl;
+        glDeleteProgram(entry.program);
+        entry.program = 0;
+    }
+    else if (!entry.cacheKey.empty())
+    {
+        programBinaryCache.store(entry.cacheKey, entry.program);
+    }
+
+    for (unsigned int shader : entry.shaders)
+        glDeleteShader(shader);
+    entry.shaders.clear();
+    entry.stages.clear();
+    entry.done = true;
+    pending--;
+}
+
+void ProgramBuilder::poll()
+{
+    for (Entry& entry : entries)
+    {
+        if (entry.done)
+            continue;
+        if (parallelCompile)
+        {
+            GLint complete = 0;
+            glGetProgramiv(entry.program, GL_COMPLETION_STATUS_KHR, &complete);
+            if (complete)
+                finish(entry);
+        }
+        else
+        {
+            finish(entry);
+            return;
+        }
+    }
+}
+
+unsigned int ProgramBuilder::wait(int handle)
+{
+    if (handle < 0)
+        return 0;
+    Entry& entry = entries[handle];
+    if (!entry.done)
+        finish(entry);
+    return entry.program;
+}
+
+void ProgramBuilder::release()
+{
+    for (Entry& entry : entries)
+    {
+        if (entry.done)
+            continue;
+        for (unsigned int shader : entry.shaders)
+            glDeleteShader(shader);
+        glDeleteProgram(entry.program);
+        entry.program = 0;
+        entry.done = true;
+    }
+    entries.clear();
+    pending = 0;
+}
+
+unsigned int buildProgram(const std::vector<ShaderStage>& stages)
+{
+    ProgramBuilder builder;
+    return builder.wait(builder.submit(stages));
+}
@@ -0,0 +1,69 @@
+#ifndef PROGRAM_BUILDER_H
+#define PROGRAM_BUILDER_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+// 一个着色器阶段：type 为 GL_VERTEX_SHADER 等，source 为预处理后的源码，path 只用于错误信息
+struct ShaderStage
+{
+    unsigned int type;
+    std::string source;
+    std::string path;
+};
+
+// 异步构建着色器程序。
+//
+// submit 只发出编译和链接命令，不查询状态；驱动支持 GL_KHR_parallel_shader_compile 时在自己的线程上编译，
+// poll 用 GL_COMPLETION_STATUS_KHR 非阻塞地找出已完成的程序，这时才取链接状态和错误日志。
+// 没有该扩展时查询状态会阻塞，poll 每次只结束一个程序，把等待分散到多帧。
+// 程序二进制缓存（programBinaryCache）命中的程序在 submit 时就已就绪。
+// 已就绪的程序归调用者所有；release 只删除还没完成的程序。
+class ProgramBuilder
+{
+public:
+    ProgramBuilder();
+    ~ProgramBuilder();
+
+    // 在 gladLoadGLLoader 之后调用，检测并启用并行编译扩展；不调用时所有程序在 poll/wait 时逐个结束
+    bool init(GLADloadproc load);
+    bool parallel() const { return parallelCompile; }
+
+    // 返回句柄，之后用 program/wait 取结果；下面的查询都接受 -1 表示“没有提交”
+    int submit(const std::vector<ShaderStage>& stages);
+
+    // 结束已完成的程序，每帧调用一次
+    void poll();
+    // 阻塞到该程序完成
+    unsigned int wait(int handle);
+
+    bool finished(int handle) const { return handle < 0 || entries[handle].done; }
+    // 已就绪的程序；还在编译或构建失败时返回 0
+    unsigned int program(int handle) const { return handle >= 0 && entries[handle].done ? entries[handle].program : 0; }
+    size_t pendingCount() const { return pending; }
+
+    void release();
+
+private:
+    struct Entry
+    {
+        unsigned int program;
+        std::vector<unsigned int> shaders;
+        std::vector<ShaderStage> stages;    // 出错时用于报告文件名
+        std::string cacheKey;
+        bool done;
+    };
+
+    void finish(Entry& entry);
+
+    std::vector<Entry> entries;
+    size_t pending;
+    bool parallelCompile;
+};
+
+// 同步构建：提交后立即等待结果，失败返回 0
+unsigned int buildProgram(const std::vector<ShaderStage>& stages);
+
+#endif // PROGRAM_BUILDER_H
@@ -0,0 +1,231 @@
+#include "program_cache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// glad 只生成了 OpenGL 3.3 Core，程序二进制的入口在这里按需加载
+#ifndef GL_VERSION_4_1
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT  0x8257
+#define GL_PROGRAM_BINARY_LENGTH            0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS       0x87FE
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+namespace
+{
+    PFNGLGETPROGRAMBINARYPROC glext_GetProgramBinary = NULL;
+    PFNGLPROGRAMBINARYPROC glext_ProgramBinary = NULL;
+    PFNGLPROGRAMPARAMETERIPROC glext_ProgramParameteri = NULL;
+}
+
+#define glGetProgramBinary glext_GetProgramBinary
+#define glProgramBinary glext_ProgramBinary
+#define glProgramParameteri glext_ProgramParameteri
+#endif
+
+ProgramBinaryCache programBinaryCache;
+
+namespace
+{
+    const char MAGIC[4] = { 'S', 'E', 'M', 'P' };
+
+    // FNV-1a 64位
+    unsigned long long hashBytes(unsigned long long hash, const char* data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string glString(GLenum name)
+    {
+        const char* value = (const char*)glGetString(name);
+        return value ? value : "";
+    }
+
+    // 逐级创建目录，已存在的忽略
+    void makeDirectories(const std::string& path)
+    {
+        for (size_t pos = path.find_first_of("/\\", 1); ; pos = path.find_first_of("/\\", pos + 1))
+        {
+            std::string prefix = path.substr(0, pos);
+#ifdef _WIN32
+            _mkdir(prefix.c_str());
+#else
+            mkdir(prefix.c_str(), 0755);
+#endif
+            if (pos == std::string::npos)
+                break;
+        }
+    }
+}
+
+ProgramBinaryCache::ProgramBinaryCache()
+    : hits(0), misses(0), rejected(0), active(false), loadEnabled(true), storeEnabled(true), directoryCreated(false)
+{
+}
+
+std::string ProgramBinaryCache::defaultDirectory(const std::string& application)
+{
+    std::string root;
+#ifdef _WIN32
+    const char* localAppData = getenv("LOCALAPPDATA");
+    if (localAppData && *localAppData)
+        root = localAppData;
+#else
+    const char* home = getenv("HOME");
+#ifdef __APPLE__
+    if (home && *home)
+        root = std::string(home) + "/Library/Caches";
+#else
+    const char* xdgCache = getenv("XDG_CACHE_HOME");
+    if (xdgCache && *xdgCache == '/')
+        root = xdgCache;
+    else if (home && *home)
+        root = std::string(home) + "/.cache";
+#endif
+#endif
+    if (root.empty())
+        return root;
+    return root + "/" + application + "/shader_cache";
+}
+
+bool ProgramBinaryCache::init(GLADloadproc load, const std::string& dir)
+{
+#ifndef GL_VERSION_4_1
+    glext_GetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+    glext_ProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+    glext_ProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+#else
+    (void)load;
+#endif
+    active = false;
+    if (dir.empty() || !glGetProgramBinary || !glProgramBinary || !glProgramParameteri)
+        return false;
+
+    // 有些驱动提供了入口但不支持任何格式，此时取回的二进制无法再加载
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    glGetError();
+    if (formats <= 0)
+        return false;
+
+    directory = dir;
+    directoryCreated = false;
+    driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+    active = true;
+    return true;
+}
+
+std::string ProgramBinaryCache::makeKey(const std::vector<std::pair<unsigned int, std::string> >& sources) const
+{
+    unsigned long long hash = 14695981039346656037ull;
+    hash = hashBytes(hash, driver.c_str(), driver.size() + 1);
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        unsigned int type = sources[i].first;
+        hash = hashBytes(hash, (const char*)&type, sizeof(type));
+        hash = hashBytes(hash, sources[i].second.c_str(), sources[i].second.size() + 1);
+    }
+
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", hash);
+    return key;
+}
+
+std::string ProgramBinaryCache::pathFor(const std::string& key) const
+{
+    return directory + "/" + key + ".bin";
+}
+
+unsigned int ProgramBinaryCache::load(const std::string& key)
+{
+    if (!active || !loadEnabled)
+        return 0;
+
+    // 文件格式：魔数(4) | 二进制格式(4) | 长度(4) | 二进制
+    std::ifstream file(pathFor(key).c_str(), std::ios::binary);
+    char magic[4];
+    GLenum format = 0;
+    GLint length = 0;
+    if (!file.read(magic, 4) || memcmp(magic, MAGIC, 4) != 0
+        || !file.read((char*)&format, sizeof(format)) || !file.read((char*)&length, sizeof(length)) || length <= 0)
+    {
+        misses++;
+        return 0;
+    }
+    std::vector<char> binary(length);
+    if (!file.read(binary.data(), length))
+    {
+        misses++;
+        return 0;
+    }
+    file.close();
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), length);
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        // 驱动更新后旧格式可能被拒绝，删掉文件，下次重新生成
+        glDeleteProgram(program);
+        std::remove(pathFor(key).c_str());
+        rejected++;
+        return 0;
+    }
+    hits++;
+    return program;
+}
+
+void ProgramBinaryCache::prepare(unsigned int program) const
+{
+    if (active)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramBinaryCache::store(const std::string& key, unsigned int program)
+{
+    if (!active || !storeEnabled)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    if (length <= 0)
+        return;
+
+    if (!directoryCreated)
+    {
+        makeDirectories(directory);
+        directoryCreated = true;
+    }
+    std::ofstream file(pathFor(key).c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "ERROR::SHADER::CACHE::WRITE_FAILED " << pathFor(key) << std::endl;
+        return;
+    }
+    file.write(MAGIC, 4);
+    file.write((const char*)&format, sizeof(format));
+    file.write((const char*)&length, sizeof(length));
+    file.write(binary.data(), length);
+}
@@ -0,0 +1,58 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+// 链接好的着色器程序二进制的磁盘缓存（glGetProgramBinary / glProgramBinary，GL 4.1 或 ARB_get_program_binary）。
+//
+// 键是预处理后各阶段源码（已包含注入的 #define）与驱动的 vendor/renderer/version 字符串的哈希，
+// 换驱动或改着色器都会自然地错过缓存。驱动拒绝二进制（链接状态为假）时删除该文件，由调用者回退到源码编译。
+class ProgramBinaryCache
+{
+public:
+    ProgramBinaryCache();
+
+    // 用户缓存目录下 application 的缓存目录（Windows 为 %LOCALAPPDATA%，macOS 为 ~/Library/Caches，
+    // 其他系统为 $XDG_CACHE_HOME 或 ~/.cache），与启动时的工作目录无关；找不到时返回空串
+    static std::string defaultDirectory(const std::string& application);
+
+    // 在 gladLoadGLLoader 之后调用；驱动不支持任何二进制格式或目录为空时缓存保持关闭。
+    // 初始化不访问磁盘，目录在第一次写入时才创建
+    bool init(GLADloadproc load, const std::string& directory);
+    bool enabled() const { return active; }
+
+    // 为 false 时 load 总是未命中，供基准测试测量冷启动
+    void setLoadEnabled(bool enable) { loadEnabled = enable; }
+    // 为 false 时 store 不写文件，冷启动的计时不包含磁盘写入
+    void setStoreEnabled(bool enable) { storeEnabled = enable; }
+
+    // sources 为各阶段 (类型, 源码)
+    std::string makeKey(const std::vector<std::pair<unsigned int, std::string> >& sources) const;
+
+    // 命中时返回已链接的程序，未命中或驱动拒绝时返回 0
+    unsigned int load(const std::string& key);
+    // 在 glLinkProgram 之前调用，允许驱动保留可取回的二进制
+    void prepare(unsigned int program) const;
+    void store(const std::string& key, unsigned int program);
+
+    size_t hits;
+    size_t misses;
+    size_t rejected;
+
+private:
+    std::string pathFor(const std::string& key) const;
+
+    bool active;
+    bool loadEnabled;
+    bool storeEnabled;
+    bool directoryCreated;
+    std::string directory;
+    std::string driver;     // vendor/renderer/version，参与键的计算
+};
+
+extern ProgramBinaryCache programBinaryCache;
+
+#endif // PROGRAM_CACHE_H
@@ -0,0 +1,108 @@
+#include "resource_files.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    std::vector<const EmbeddedResource*> embeddedResources;
+    std::string overrideDir;
+
+    const EmbeddedResource* findEmbedded(const std::string& path)
+    {
+        for (const EmbeddedResource* resource : embeddedResources)
+        {
+            if (path == resource->path)
+                return resource;
+        }
+        return NULL;
+    }
+
+    bool readFile(const std::string& path, std::string& content)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (!file)
+            return false;
+        std::stringstream stream;
+        stream << file.rdbuf();
+        content = stream.str();
+        return true;
+    }
+
+    // embed_resources 的压缩格式：控制字节最高位为 0 时后跟 (c + 1) 个字面字节，
+    // 为 1 时复制 (c & 0x7F) + 4 个字节，来源在已输出数据中向前 2 字节小端偏移处（可与目标重叠）
+    bool decompress(const EmbeddedResource& resource, std::string& out)
+    {
+        out.resize(resource.rawSize);
+        const unsigned char* in = resource.data;
+        const unsigned char* end = in + resource.size;
+        size_t pos = 0;
+        while (in < end)
+        {
+            unsigned char control = *in++;
+            if (control & 0x80)
+            {
+                if (end - in < 2)
+                    return false;
+                size_t length = (control & 0x7F) + 4;
+                size_t offset = in[0] | (in[1] << 8);
+                in += 2;
+                if (offset == 0 || offset > pos || pos + length > out.size())
+                    return false;
+                for (size_t i = 0; i < length; i++, pos++)
+                    out[pos] = out[pos - offset];
+            }
+            else
+            {
+                size_t length = (size_t)control + 1;
+                if ((size_t)(end - in) < length || pos + length > out.size())
+                    return false;
+                memcpy(&out[pos], in, length);
+                in += length;
+                pos += length;
+            }
+        }
+        return pos == out.size();
+    }
+
+    std::string overridePath(const std::string& path)
+    {
+        return overrideDir + "/" + path;
+    }
+}
+
+void registerEmbeddedResources(const EmbeddedResource* resources, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        embeddedResources.push_back(&resources[i]);
+}
+
+void setResourceOverrideDir(const std::string& dir)
+{
+    overrideDir = dir;
+}
+
+bool resourceExists(const std::string& path)
+{
+    if (!overrideDir.empty() && std::ifstream(overridePath(path).c_str()))
+        return true;
+    return findEmbedded(path) != NULL || std::ifstream(path.c_str());
+}
+
+bool readResource(const std::string& path, std::string& content)
+{
+    if (!overrideDir.empty() && readFile(overridePath(path), content))
+        return true;
+
+    const EmbeddedResource* resource = findEmbedded(path);
+    if (!resource)
+        return readFile(path, content);
+    if (!resource->compressed)
+    {
+        content.assign((const char*)resource->data, resource->size);
+        return true;
+    }
+    return decompress(*resource, content);
+}
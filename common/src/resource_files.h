@@ -0,0 +1,29 @@
+#ifndef RESOURCE_FILES_H
+#define RESOURCE_FILES_H
+
+#include <cstddef>
+#include <string>
+
+// 着色器、纹理等资源文件的读取。
+//
+// 构建时 embed_resources 把资源生成为 embedded_resources.h 中的字节数组，程序启动时注册后读取不再访问磁盘；
+// 设置了覆盖目录时先在该目录下查找同名文件（调试着色器时不必重新构建）。
+// 没有注册的资源按路径从工作目录读取，与以前的行为相同。
+
+struct EmbeddedResource
+{
+    const char* path;               // 资源名，如 "shaders/vertex_shader.glsl"
+    const unsigned char* data;
+    size_t size;                    // data 的字节数
+    size_t rawSize;                 // 解压后的字节数
+    bool compressed;
+};
+
+void registerEmbeddedResources(const EmbeddedResource* resources, size_t count);
+void setResourceOverrideDir(const std::string& dir);
+
+bool resourceExists(const std::string& path);
+// 读取失败返回 false，由调用者报告错误
+bool readResource(const std::string& path, std::string& content);
+
+#endif // RESOURCE_FILES_H
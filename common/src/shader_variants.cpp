@@ -0,0 +1,189 @@
+#include "shader_variants.h"
+
+#include "resource_files.h"
+
+#include <glad/glad.h>
+
+#include <iostream>
+#include <set>
+#include <sstream>
+
+const std::vector<const char*> LIGHTING_FEATURE_NAMES = { "EMISSIVE", "TEXTURED", "BACK_LIGHT" };
+
+namespace
+{
+    std::string directoryOf(const std::string& path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    // 展开一个文件，included 记录已展开过的文件路径
+    bool expand(const std::string& path, const std::vector<std::string>& includeDirs,
+                std::set<std::string>& included, std::string& out)
+    {
+        std::string source;
+        if (!readResource(path, source))
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        included.insert(path);
+
+        std::istringstream lines(source);
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(lines, line))
+        {
+            lineNumber++;
+            size_t start = line.find_first_not_of(" \t");
+            if (start == std::string::npos || line.compare(start, 8, "#include") != 0)
+            {
+                out += line;
+                out += '\n';
+                continue;
+            }
+
+            size_t open = line.find('"', start);
+            size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+            if (close == std::string::npos)
+            {
+                std::cout << "ERROR::SHADER::BAD_INCLUDE: " << path << ":" << lineNumber << std::endl;
+                return false;
+            }
+            std::string name = line.substr(open + 1, close - open - 1);
+
+            // 先找包含者所在目录，再找附加目录
+            std::string resolved = directoryOf(path) + name;
+            for (size_t i = 0; !resourceExists(resolved) && i < includeDirs.size(); i++)
+                resolved = includeDirs[i] + "/" + name;
+
+            if (!included.count(resolved))
+            {
+                out += "#line 1\n";
+                if (!expand(resolved, includeDirs, included, out))
+                    return false;
+            }
+            // 恢复行号，编译错误信息仍指向原文件的行
+            out += "#line " + std::to_string(lineNumber + 1) + "\n";
+        }
+        return true;
+    }
+
+}
+
+std::string preprocessShader(const std::string& path, const std::vector<std::string>& defines,
+                             const std::vector<std::string>& includeDirs)
+{
+    std::set<std::string> included;
+    std::string expanded;
+    if (!expand(path, includeDirs, included, expanded))
+        return std::string();
+
+    // #version 必须是第一条语句，宏插在它后面
+    std::string defineBlock;
+    for (const std::string& define : defines)
+        defineBlock += "#define " + define + "\n";
+    size_t version = expanded.find("#version");
+    size_t insertAt = version == std::string::npos ? 0 : expanded.find('\n', version);
+    if (insertAt == std::string::npos)
+        insertAt = expanded.size();
+    else if (version != std::string::npos)
+        insertAt++;
+    if (!defineBlock.empty())
+        defineBlock += "#line 2\n";
+    expanded.insert(insertAt, defineBlock);
+    return expanded;
+}
+
+ShaderVariants::ShaderVariants(const char* vertexPath, const char* fragmentPath, const std::vector<const char*>& featureNames)
+    : vertexPath(vertexPath), fragmentPath(fragmentPath), featureNames(featureNames), builder(NULL)
+{
+}
+
+ShaderVariants::~ShaderVariants()
+{
+    release();
+}
+
+void ShaderVariants::addIncludeDir(const std::string& dir)
+{
+    includeDirs.push_back(dir);
+}
+
+void ShaderVariants::addDefine(const std::string& define)
+{
+    commonDefines.push_back(define);
+}
+
+unsigned int ShaderVariants::get(unsigned int features)
+{
+    std::map<unsigned int, unsigned int>::iterator it = programs.find(features);
+    if (it != programs.end())
+        return it->second;
+
+    std::map<unsigned int, int>::iterator pending = building.find(features);
+    if (pending != building.end())
+    {
+        if (!builder->finished(pending->second))
+            return 0;
+        unsigned int program = builder->program(pending->second);
+        if (!program)
+            std::cout << "ERROR::SHADER::VARIANT_FAILED " << fragmentPath
+                      << " (features 0x" << std::hex << features << std::dec << ")" << std::endl;
+        programs[features] = program;
+        building.erase(pending);
+        return program;
+    }
+
+    std::vector<std::string> defines = commonDefines;
+    for (size_t i = 0; i < featureNames.size(); i++)
+    {
+        if (features & (1u << i))
+            defines.push_back(featureNames[i]);
+    }
+
+    unsigned int program = 0;
+    std::string vertexCode = preprocessShader(vertexPath, defines, includeDirs);
+    std::string fragmentCode = preprocessShader(fragmentPath, defines, includeDirs);
+    if (!vertexCode.empty() && !fragmentCode.empty())
+    {
+        std::vector<ShaderStage> stages(2);
+        stages[0].type = GL_VERTEX_SHADER;
+        stages[0].source = vertexCode;
+        stages[0].path = vertexPath;
+        stages[1].type = GL_FRAGMENT_SHADER;
+        stages[1].source = fragmentCode;
+        stages[1].path = fragmentPath;
+        if (builder)
+        {
+            building[features] = builder->submit(stages);
+            return get(features);
+        }
+        program = buildProgram(stages);
+        if (!program)
+            std::cout << "ERROR::SHADER::VARIANT_FAILED " << fragmentPath
+                      << " (features 0x" << std::hex << features << std::dec << ")" << std::endl;
+    }
+
+    programs[features] = program;
+    return program;
+}
+
+void ShaderVariants::release()
+{
+    for (std::map<unsigned int, unsigned int>::iterator it = programs.begin(); it != programs.end(); ++it)
+    {
+        if (it->second)
+            glDeleteProgram(it->second);
+    }
+    programs.clear();
+
+    // 已经构建完但还没被 get 取走的程序也归这里
+    for (std::map<unsigned int, int>::iterator it = building.begin(); it != building.end(); ++it)
+    {
+        if (builder->program(it->second))
+            glDeleteProgram(builder->program(it->second));
+    }
+    building.clear();
+}
@@ -0,0 +1,62 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include "program_builder.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// ex1 与 ex2 共用的着色器预处理与变体缓存。
+//
+// 着色器源码可以 #include "文件"（先在包含者所在目录查找，再依次查找附加目录，同一文件只展开一次），
+// 编译前在 #version 行之后插入 #define。一对顶点/片段着色器按特性位掩码生成不同的变体，
+// 每个变体只在第一次使用时编译，之后从缓存返回，片段着色器里不再有按 uniform 的动态分支。
+
+// common/shaders/lighting.glsl 支持的特性
+enum LightingFeature
+{
+    LIGHTING_EMISSIVE   = 1 << 0,   // 自发光（太阳），不计算光照
+    LIGHTING_TEXTURED   = 1 << 1,   // 基础颜色来自纹理
+    LIGHTING_BACK_LIGHT = 1 << 2,   // 第二个较弱的背光源
+};
+
+// 与 LightingFeature 的位一一对应的宏名
+extern const std::vector<const char*> LIGHTING_FEATURE_NAMES;
+
+// 读取 path 并展开 #include，在 #version 之后插入 defines（每项形如 "NAME" 或 "NAME 值"）
+std::string preprocessShader(const std::string& path, const std::vector<std::string>& defines,
+                             const std::vector<std::string>& includeDirs);
+
+class ShaderVariants
+{
+public:
+    // featureNames[i] 是特性位 (1 << i) 对应的宏名
+    ShaderVariants(const char* vertexPath, const char* fragmentPath, const std::vector<const char*>& featureNames);
+    ~ShaderVariants();
+
+    void addIncludeDir(const std::string& dir);
+    // 所有变体共用的宏，如 ex1 的光照参数 "AMBIENT_STRENGTH 0.75"
+    void addDefine(const std::string& define);
+
+    // 设置后变体交给 builder 异步构建，get 在编译完成前返回 0
+    void setBuilder(ProgramBuilder* builder) { this->builder = builder; }
+
+    // 返回该特性组合的程序，第一次请求时编译；失败返回 0（也会被缓存，不会反复编译）
+    unsigned int get(unsigned int features);
+    void release();
+
+    size_t variantCount() const { return programs.size() + building.size(); }
+
+private:
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::vector<const char*> featureNames;
+    std::vector<std::string> includeDirs;
+    std::vector<std::string> commonDefines;
+    std::map<unsigned int, unsigned int> programs;
+    ProgramBuilder* builder;
+    std::map<unsigned int, int> building;   // 特性组合 -> builder 句柄
+};
+
+#endif // SHADER_VARIANTS_H
@@ -0,0 +1,171 @@
+// 构建时工具：把着色器和纹理转换成头文件中的 constexpr 字节数组，由 CMake 调用
+//
+// 用法：embed_resources [--compress] <输出头文件> <资源名>=<文件路径>...
+// 资源名即运行时 readResource 使用的路径（如 shaders/vertex_shader.glsl）。
+// --compress 时对每个资源做简单的 LZ 压缩（格式见 common/src/resource_files.cpp），压缩后不更小的保持原样。
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t MIN_MATCH = 4;
+    const size_t MAX_MATCH = 127 + MIN_MATCH;
+    const size_t MAX_LITERALS = 128;
+    const size_t MAX_OFFSET = 65535;
+    const int HASH_BITS = 16;
+
+    // 控制字节最高位为 0：后面跟 (c + 1) 个字面字节；为 1：匹配长度 (c & 0x7F) + 4，后跟 2 字节小端偏移
+    void flushLiterals(const std::vector<unsigned char>& input, size_t start, size_t end, std::vector<unsigned char>& out)
+    {
+        while (start < end)
+        {
+            size_t run = std::min(end - start, MAX_LITERALS);
+            out.push_back((unsigned char)(run - 1));
+            out.insert(out.end(), input.begin() + start, input.begin() + start + run);
+            start += run;
+        }
+    }
+
+    std::vector<unsigned char> compress(const std::vector<unsigned char>& input)
+    {
+        std::vector<unsigned char> out;
+        std::vector<size_t> table((size_t)1 << HASH_BITS, (size_t)-1);   // 4字节序列哈希 -> 最近出现的位置
+        size_t literalStart = 0;
+        size_t pos = 0;
+        while (pos + MIN_MATCH <= input.size())
+        {
+            unsigned int sequence;
+            memcpy(&sequence, &input[pos], 4);
+            size_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+            size_t candidate = table[hash];
+            table[hash] = pos;
+
+            if (candidate != (size_t)-1 && pos - candidate <= MAX_OFFSET && memcmp(&input[candidate], &input[pos], MIN_MATCH) == 0)
+            {
+                size_t length = MIN_MATCH;
+                while (length < MAX_MATCH && pos + length < input.size() && input[candidate + length] == input[pos + length])
+                    length++;
+
+                flushLiterals(input, literalStart, pos, out);
+                size_t offset = pos - candidate;
+                out.push_back((unsigned char)(0x80 | (length - MIN_MATCH)));
+                out.push_back((unsigned char)(offset & 0xFF));
+                out.push_back((unsigned char)(offset >> 8));
+                pos += length;
+                literalStart = pos;
+            }
+            else
+            {
+                pos++;
+            }
+        }
+        flushLiterals(input, literalStart, input.size(), out);
+        return out;
+    }
+
+    bool readFile(const std::string& path, std::vector<unsigned char>& content)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (!file)
+            return false;
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool compressResources = false;
+    int first = 1;
+    if (argc > 1 && strcmp(argv[1], "--compress") == 0)
+    {
+        compressResources = true;
+        first++;
+    }
+    if (argc - first < 1)
+    {
+        std::cout << "usage: embed_resources [--compress] <output.h> <name>=<path>..." << std::endl;
+        return 1;
+    }
+
+    std::ostringstream header;
+    header << "// 由 embed_resources 在构建时生成，不要手动修改\n"
+           << "#ifndef EMBEDDED_RESOURCES_H\n#define EMBEDDED_RESOURCES_H\n\n"
+           << "#include \"resource_files.h\"\n\n"
+           << "namespace embedded\n{\n";
+
+    std::ostringstream table;
+    size_t rawTotal = 0;
+    size_t storedTotal = 0;
+    int count = 0;
+    for (int i = first + 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos)
+        {
+            std::cout << "ERROR::EMBED::BAD_ARGUMENT: " << arg << std::endl;
+            return 1;
+        }
+        std::string name = arg.substr(0, eq);
+        std::vector<unsigned char> data;
+        if (!readFile(arg.substr(eq + 1), data))
+        {
+            std::cout << "ERROR::EMBED::FILE_NOT_SUCCESSFULLY_READ: " << arg.substr(eq + 1) << std::endl;
+            return 1;
+        }
+
+        size_t rawSize = data.size();
+        bool compressed = false;
+        if (compressResources)
+        {
+            std::vector<unsigned char> packed = compress(data);
+            if (packed.size() < data.size())
+            {
+                data.swap(packed);
+                compressed = true;
+            }
+        }
+        rawTotal += rawSize;
+        storedTotal += data.size();
+
+        // 空文件也输出一个字节，避免零长度数组
+        header << "    constexpr unsigned char data" << count << "[] = {";
+        for (size_t b = 0; b < std::max<size_t>(data.size(), 1); b++)
+        {
+            if (b % 16 == 0)
+                header << "\n        ";
+            char hex[8];
+            snprintf(hex, sizeof(hex), "0x%02x,", b < data.size() ? data[b] : 0);
+            header << hex;
+        }
+        header << "\n    };\n";
+
+        table << "    { \"" << name << "\", embedded::data" << count << ", " << data.size() << ", " << rawSize << ", "
+              << (compressed ? "true" : "false") << " },\n";
+        count++;
+    }
+
+    header << "}\n\n"
+           << "static const EmbeddedResource EMBEDDED_RESOURCES[] = {\n" << table.str() << "};\n"
+           << "static const size_t EMBEDDED_RESOURCE_COUNT = " << count << ";\n\n"
+           << "#endif // EMBEDDED_RESOURCES_H\n";
+
+    std::string output = argv[first];
+    std::ofstream file(output.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "ERROR::EMBED::WRITE_FAILED: " << output << std::endl;
+        return 1;
+    }
+    file << header.str();
+    std::cout << "Embedded " << count << " resources: " << rawTotal << " bytes -> " << storedTotal << " bytes" << std::endl;
+    return 0;
+}
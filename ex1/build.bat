@@ -74,6 +74,7 @@ echo.
 cd ..
 if not exist build\bin mkdir build\bin
 xcopy /Y /I shaders build\bin\shaders\
+xcopy /Y /I ..\common\shaders build\bin\shaders\
 if exist build\bin\Release\SunEarthMoon.exe (
     move /Y build\bin\Release\SunEarthMoon.exe build\bin\
 )
@@ -4,9 +4,10 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "program_cache.h"
+#include "shader_variants.h"
+
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <cmath>
 
@@ -37,8 +38,6 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
-std::string readShaderFile(const char* filePath);
-unsigned int createShaderProgram(const char* vertexPath, const char* fragmentPath);
 void createSphere(std::vector<float>& vertices, std::vector<unsigned int>& indices, int segments = 20);
 
 int main()
@@ -72,11 +71,25 @@ int main()
         return -1;
     }
 
+    // 程序二进制缓存：第二次启动起跳过着色器编译；放在用户缓存目录，与启动时的工作目录无关
+    programBinaryCache.init((GLADloadproc)glfwGetProcAddress, ProgramBinaryCache::defaultDirectory("SunEarthMoon-ex1"));
+
     // 配置OpenGL状态
     glEnable(GL_DEPTH_TEST);
 
-    // 创建着色器程序
-    unsigned int shaderProgram = createShaderProgram("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl");
+    // 创建着色器程序：与 ex2 共用 common/shaders/lighting.glsl，太阳和行星分别编译自发光/受光照变体
+    ShaderVariants shaders("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl", LIGHTING_FEATURE_NAMES);
+    shaders.addIncludeDir("../common/shaders");
+    // 实验一的光照参数：环境光更强，让行星更明亮，衰减更弱
+    shaders.addDefine("AMBIENT_STRENGTH 0.75");
+    shaders.addDefine("AMBIENT_COLOR vec3(1.0, 1.0, 0.9)");
+    shaders.addDefine("DIFFUSE_COLOR vec3(1.5, 1.5, 1.4)");
+    shaders.addDefine("SPECULAR_STRENGTH 0.5");
+    shaders.addDefine("SPECULAR_COLOR vec3(1.0, 1.0, 0.9)");
+    shaders.addDefine("ATTENUATION_LINEAR 0.005");
+    shaders.addDefine("ATTENUATION_QUADRATIC 0.0001");
+    unsigned int sunProgram = shaders.get(LIGHTING_EMISSIVE);
+    unsigned int planetProgram = shaders.get(0);
 
     // 创建球体网格（使用较低的细分以提高性能）
     std::vector<float> vertices;
@@ -121,17 +134,19 @@ int main()
         glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // 使用着色器
-        glUseProgram(shaderProgram);
-
         // 设置变换矩阵
         glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 1000.0f);
         glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
 
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 1, glm::value_ptr(cameraPos));
-        glUniform3f(glGetUniformLocation(shaderProgram, "lightPos"), 0.0f, 0.0f, 0.0f); // 太阳位置
+        const unsigned int programs[] = { sunProgram, planetProgram };
+        for (unsigned int program : programs)
+        {
+            glUseProgram(program);
+            glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+            glUniform3fv(glGetUniformLocation(program, "viewPos"), 1, glm::value_ptr(cameraPos));
+            glUniform3f(glGetUniformLocation(program, "sunLightPos"), 0.0f, 0.0f, 0.0f); // 太阳位置
+        }
 
         glBindVertexArray(VAO);
 
@@ -142,9 +157,9 @@ int main()
         {
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::scale(model, glm::vec3(10.0f)); // 太阳半径
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 1.0f, 0.9f, 0.2f);
-            glUniform1i(glGetUniformLocation(shaderProgram, "isSun"), 1);
+            glUseProgram(sunProgram);
+            glUniformMatrix4fv(glGetUniformLocation(sunProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
+            glUniform3f(glGetUniformLocation(sunProgram, "objectColor"), 1.0f, 0.9f, 0.2f);
             glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
         }
 
@@ -164,9 +179,9 @@ int main()
             model = glm::translate(model, earthPos);
             model = glm::rotate(model, time * earthRotationSpeed, glm::vec3(0.0f, 1.0f, 0.0f)); // 自转
             model = glm::scale(model, glm::vec3(3.0f)); // 地球半径
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 0.2f, 0.4f, 0.8f);
-            glUniform1i(glGetUniformLocation(shaderProgram, "isSun"), 0);
+            glUseProgram(planetProgram);
+            glUniformMatrix4fv(glGetUniformLocation(planetProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
+            glUniform3f(glGetUniformLocation(planetProgram, "objectColor"), 0.2f, 0.4f, 0.8f);
             glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
         }
 
@@ -186,9 +201,8 @@ int main()
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, moonPos);
             model = glm::scale(model, glm::vec3(1.0f)); // 月球半径
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 0.7f, 0.7f, 0.7f);
-            glUniform1i(glGetUniformLocation(shaderProgram, "isSun"), 0);
+            glUniformMatrix4fv(glGetUniformLocation(planetProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
+            glUniform3f(glGetUniformLocation(planetProgram, "objectColor"), 0.7f, 0.7f, 0.7f);
             glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
         }
 
@@ -201,7 +215,7 @@ int main()
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
-    glDeleteProgram(shaderProgram);
+    shaders.release();
 
     glfwTerminate();
     return 0;
@@ -246,81 +260,6 @@ void createSphere(std::vector<float>& vertices, std::vector<unsigned int>& indic
     }
 }
 
-// 读取着色器文件
-std::string readShaderFile(const char* filePath)
-{
-    std::string content;
-    std::ifstream file;
-    file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try
-    {
-        file.open(filePath);
-        std::stringstream stream;
-        stream << file.rdbuf();
-        file.close();
-        content = stream.str();
-    }
-    catch (std::ifstream::failure& e)
-    {
-        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << filePath << std::endl;
-    }
-
-    return content;
-}
-
-// 创建着色器程序
-unsigned int createShaderProgram(const char* vertexPath, const char* fragmentPath)
-{
-    std::string vertexCode = readShaderFile(vertexPath);
-    std::string fragmentCode = readShaderFile(fragmentPath);
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    unsigned int vertex, fragment;
-    int success;
-    char infoLog[512];
-
-    // 顶点着色器
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // 片段着色器
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // 着色器程序
-    unsigned int program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
-    glLinkProgram(program);
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(program, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-
-    return program;
-}
-
 // 处理输入
 void processInput(GLFWwindow *window)
 {
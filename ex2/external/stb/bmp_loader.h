@@ -29,53 +29,50 @@ typedef struct {
 } BMPInfoHeader;
 #pragma pack(pop)
 
-unsigned char* loadBMP(const char* filename, int* width, int* height, int* channels) {
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        printf("Error: Cannot open file %s\n", filename);
-        return NULL;
-    }
-
+// 从内存中的完整BMP文件解码（资源可能编译进了程序）
+unsigned char* loadBMPFromMemory(const unsigned char* buffer, size_t size, int* width, int* height, int* channels) {
     // Read BMP header
     BMPHeader header;
-    fread(&header.type, sizeof(unsigned short), 1, file);
-    fread(&header.size, sizeof(unsigned int), 1, file);
-    fread(&header.reserved1, sizeof(unsigned short), 1, file);
-    fread(&header.reserved2, sizeof(unsigned short), 1, file);
-    fread(&header.offset, sizeof(unsigned int), 1, file);
+    BMPInfoHeader infoHeader;
+    if (size < 14 + sizeof(BMPInfoHeader)) {
+        printf("Error: Not a BMP file\n");
+        return NULL;
+    }
+    memcpy(&header.type, buffer, sizeof(unsigned short));
+    memcpy(&header.size, buffer + 2, sizeof(unsigned int));
+    memcpy(&header.reserved1, buffer + 6, sizeof(unsigned short));
+    memcpy(&header.reserved2, buffer + 8, sizeof(unsigned short));
+    memcpy(&header.offset, buffer + 10, sizeof(unsigned int));
 
     // Check if it's a BMP file
     if (header.type != 0x4D42) { // 'BM' in little endian
         printf("Error: Not a BMP file\n");
-        fclose(file);
         return NULL;
     }
 
     // Read Info Header
-    BMPInfoHeader infoHeader;
-    fread(&infoHeader, sizeof(BMPInfoHeader), 1, file);
+    memcpy(&infoHeader, buffer + 14, sizeof(BMPInfoHeader));
 
     *width = infoHeader.width;
     *height = infoHeader.height;
     *channels = infoHeader.bitsPerPixel / 8;
 
-    // Move to pixel data
-    fseek(file, header.offset, SEEK_SET);
-
     // Calculate row size (must be multiple of 4)
     int rowSize = ((*width) * (*channels) + 3) & ~3;
     int dataSize = rowSize * abs(*height);
+    if (header.offset > size || size - header.offset < (size_t)dataSize) {
+        printf("Error: Truncated BMP file\n");
+        return NULL;
+    }
 
     unsigned char* data = (unsigned char*)malloc(dataSize);
     if (!data) {
         printf("Error: Cannot allocate memory\n");
-        fclose(file);
         return NULL;
     }
 
     // Read pixel data
-    fread(data, 1, dataSize, file);
-    fclose(file);
+    memcpy(data, buffer + header.offset, dataSize);
 
     // BMP is stored bottom-to-top, so flip it
     if (*height > 0) {
@@ -104,6 +101,30 @@ unsigned char* loadBMP(const char* filename, int* width, int* height, int* chann
     return data;
 }
 
+unsigned char* loadBMP(const char* filename, int* width, int* height, int* channels) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        printf("Error: Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char* buffer = (unsigned char*)malloc(size > 0 ? size : 1);
+    if (!buffer) {
+        printf("Error: Cannot allocate memory\n");
+        fclose(file);
+        return NULL;
+    }
+    size_t read = fread(buffer, 1, size > 0 ? size : 0, file);
+    fclose(file);
+
+    unsigned char* data = loadBMPFromMemory(buffer, read, width, height, channels);
+    free(buffer);
+    return data;
+}
+
 void freeBMP(unsigned char* data) {
     if (data) {
         free(data);
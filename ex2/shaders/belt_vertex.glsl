@@ -0,0 +1,34 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in vec4 aOrbit;       // 半径, 角速度, 相位, 倾角
+layout (location = 4) in vec3 aOrbitExtra;  // 升交点经度, 缩放, 周期内整圈数
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 originOffset;  // 小行星带中心（世界原点）相对相机的位置，FragPos 在相机空间中
+uniform vec2 orbitPhase;    // 模拟时间在小行星带周期内的比例（高位, 低位）
+
+void main()
+{
+    // 圆轨道：轨道面内位置 -> 绕X轴倾斜 -> 绕Y轴旋转（与 AsteroidBelt::instancePosition 一致）
+    // 整圈数 × 高位在 float 中是精确的，先取小数再加低位，角度不随模拟时间增长损失精度
+    float turns = fract(aOrbitExtra.z * orbitPhase.x) + aOrbitExtra.z * orbitPhase.y;
+    float angle = aOrbit.z + 6.28318530718 * fract(turns);
+    float px = aOrbit.x * cos(angle);
+    float pz = aOrbit.x * sin(angle);
+    vec3 center = vec3(px, pz * sin(aOrbit.w), pz * cos(aOrbit.w));
+    float cn = cos(aOrbitExtra.x), sn = sin(aOrbitExtra.x);
+    center = vec3(cn * center.x + sn * center.z, center.y, -sn * center.x + cn * center.z);
+
+    // 均匀缩放，法线无需逆转置
+    FragPos = center + originOffset + aPos * aOrbitExtra.y;
+    Normal = aNormal;
+    TexCoord = aTexCoord;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
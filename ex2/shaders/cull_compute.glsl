@@ -0,0 +1,112 @@
+#version 430 core
+layout (local_size_x = 256) in;
+
+struct Particle
+{
+    vec4 position;  // xyz: 位置, w: GM
+    vec4 velocity;  // xyz: 速度, w: 渲染缩放
+};
+
+// 与 DrawElementsIndirectCommand 一致
+struct DrawCommand
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Particles { Particle particles[]; };
+layout (std430, binding = 2) writeonly buffer VisibleInstances { uint visible[]; };
+layout (std430, binding = 3) buffer DrawCommands { DrawCommand commands[]; };
+// 点精灵档：glDrawArraysIndirect 的 count 即精灵数量
+layout (std430, binding = 4) buffer SpriteCommand
+{
+    uint spriteCount;
+    uint spriteInstanceCount;
+    uint spriteFirst;
+    uint spriteBaseInstance;
+};
+
+uniform int instanceCount;
+uniform float meshRadius;
+uniform vec4 frustumPlanes[6];  // 法线指向内侧
+uniform mat4 view;              // 只含旋转
+uniform vec3 originOffset;      // 粒子坐标原点相对相机的位置
+uniform vec2 focal;             // projection[0][0], projection[1][1]
+uniform float nearPlane;
+uniform int lodCount;
+uniform float lodDistances[4];
+uniform float viewportHeight;   // 帧缓冲高度（像素）
+uniform float spritePixels;     // 投影直径低于该值时绘制为点精灵
+uniform uint spriteBase;        // 点精灵下标在 visible 中的起始位置
+uniform int hiZLevels;          // 0 表示没有遮挡信息
+uniform sampler2D hiZ;          // 视空间线性深度，每级取 2x2 最远值
+
+// 与 OcclusionCuller::isOccluded 相同的保守测试
+bool occluded(vec3 v, float radius)
+{
+    float dist = -v.z;
+    float nearest = dist - radius;
+    if (nearest <= nearPlane)
+        return false;
+
+    float farthest = dist + radius;
+    vec2 lo = min((v.xy - radius) / nearest, (v.xy - radius) / farthest);
+    vec2 hi = max((v.xy + radius) / nearest, (v.xy + radius) / farthest);
+
+    ivec2 size = textureSize(hiZ, 0);
+    ivec2 p0 = ivec2(floor((focal * lo * 0.5 + 0.5) * vec2(size)));
+    ivec2 p1 = ivec2(floor((focal * hi * 0.5 + 0.5) * vec2(size)));
+    if (any(lessThan(p0, ivec2(0))) || any(greaterThanEqual(p1, size)))
+        return false;
+
+    // 矩形最多覆盖 2x2 个纹素的层级
+    int level = 0;
+    while (level + 1 < hiZLevels && any(greaterThan((p1 >> level) - (p0 >> level), ivec2(1))))
+        level++;
+
+    ivec2 a = p0 >> level;
+    ivec2 b = p1 >> level;
+    float maxDepth = max(max(texelFetch(hiZ, a, level).r, texelFetch(hiZ, ivec2(b.x, a.y), level).r),
+                         max(texelFetch(hiZ, ivec2(a.x, b.y), level).r, texelFetch(hiZ, b, level).r));
+    return maxDepth < nearest;
+}
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= uint(instanceCount))
+        return;
+
+    vec3 center = particles[i].position.xyz + originOffset;
+    float radius = meshRadius * particles[i].velocity.w;
+
+    // 视锥剔除
+    for (int p = 0; p < 6; p++)
+    {
+        if (dot(frustumPlanes[p].xyz, center) + frustumPlanes[p].w < -radius)
+            return;
+    }
+
+    vec3 v = (view * vec4(center, 1.0)).xyz;
+    if (hiZLevels > 0 && occluded(v, radius))
+        return;
+
+    // 投影太小或超过最后一级距离的实例绘制为点精灵
+    float dist = length(v);
+    float diameter = radius * focal.y * viewportHeight / max(-v.z, nearPlane);
+    int lod = 0;
+    while (lod < lodCount && dist > lodDistances[lod])
+        lod++;
+    if (lod == lodCount || diameter < spritePixels)
+    {
+        uint spriteSlot = atomicAdd(spriteCount, 1u);
+        visible[spriteBase + spriteSlot] = i;
+        return;
+    }
+
+    uint slot = atomicAdd(commands[lod].instanceCount, 1u);
+    visible[commands[lod].baseInstance + slot] = i;
+}
@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec4 Color;
+
+uniform sampler2D fontAtlas;
+
+void main()
+{
+    // 字体纹理只有 0/1 两种值，矩形采样的是实心格
+    FragColor = vec4(Color.rgb, Color.a * texture(fontAtlas, TexCoord).r);
+}
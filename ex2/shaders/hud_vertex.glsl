@@ -0,0 +1,16 @@
+#version 330 core
+layout (location = 0) in vec4 aPosTex; // xy: 像素坐标（左上角为原点）, zw: 字体纹理坐标
+layout (location = 1) in vec4 aColor;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+uniform vec2 viewportSize;
+
+void main()
+{
+    vec2 ndc = aPosTex.xy / viewportSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    TexCoord = aPosTex.zw;
+    Color = aColor;
+}
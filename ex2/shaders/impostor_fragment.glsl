@@ -0,0 +1,62 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 RayTarget;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+#ifdef TEXTURED
+uniform sampler2D texture1;
+#endif
+
+// 光照计算，同时声明了下面用到的 viewPos
+#include "lighting.glsl"
+
+void main()
+{
+    const float PI = 3.14159265359;
+
+    vec3 center = model[3].xyz;
+    float radius = length(model[0].xyz);
+
+    // 相机射线与解析球求交，取较近的交点。
+    // 未命中的像素仍参与下面的屏幕空间导数计算，最后才丢弃
+    vec3 dir = normalize(RayTarget - viewPos);
+    vec3 oc = center - viewPos;
+    float b = dot(dir, oc);
+    float disc = b * b - dot(oc, oc) + radius * radius;
+    float t = b - sqrt(max(disc, 0.0));
+    vec3 hit = viewPos + dir * t;
+    vec3 normal = (hit - center) / radius;
+
+#ifdef TEXTURED
+    // 纹理坐标与 createSphere 的参数化一致，需在自转前的模型空间中计算
+    vec3 local = transpose(mat3(model) / radius) * normal;
+    float uCentered = atan(local.z, local.x) / (2.0 * PI);    // [-0.5, 0.5]，接缝在背面
+    float uWrapped = fract(uCentered);                          // [0, 1)，接缝在 u = 0
+    vec2 texCoord = vec2(uWrapped, acos(clamp(local.y, -1.0, 1.0)) / PI);
+
+    // 两种参数化的接缝位置不同，取导数较小的一个计算 mip 级别，避免接缝处出现一列最低 mip 的像素
+    float u = fwidth(uCentered) < fwidth(uWrapped) ? uCentered : uWrapped;
+    vec2 dx = vec2(dFdx(u), dFdx(texCoord.y));
+    vec2 dy = vec2(dFdy(u), dFdy(texCoord.y));
+    vec3 texColor = textureGrad(texture1, texCoord, dx, dy).rgb;
+#else
+    vec3 texColor = vec3(1.0);
+#endif
+    if (disc < 0.0)
+        discard;
+
+    // 写入交点的深度，替身与网格、小行星之间可以正确遮挡
+    vec4 clip = projection * view * vec4(hit, 1.0);
+#ifdef DEPTH_ZERO_TO_ONE
+    // glClipControl(GL_ZERO_TO_ONE)：NDC 深度为 [0, 1]（反向Z，见 SceneTarget）
+    gl_FragDepth = (clip.z / clip.w) * (gl_DepthRange.far - gl_DepthRange.near) + gl_DepthRange.near;
+#else
+    gl_FragDepth = (clip.z / clip.w) * (gl_DepthRange.far - gl_DepthRange.near) * 0.5
+                 + (gl_DepthRange.far + gl_DepthRange.near) * 0.5;
+#endif
+
+    FragColor = vec4(shade(hit, normal, texColor), 1.0);
+}
@@ -0,0 +1,28 @@
+#version 330 core
+// 球体替身：不需要顶点缓冲，由 gl_VertexID 生成朝向相机的四边形（三角形带）
+
+out vec3 RayTarget;     // 四边形上的世界空间点，片段着色器由相机射向它
+
+uniform mat4 model;     // 与网格路径相同的模型矩阵（平移、自转、均匀缩放为半径）
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 viewPos;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+
+    vec3 center = model[3].xyz;
+    float radius = length(model[0].xyz);
+
+    // 四边形垂直于视线并过球心，半边长取视锥切线在该处的截面半径，保证覆盖整个轮廓
+    vec3 toCamera = viewPos - center;
+    float dist = length(toCamera);
+    vec3 w = toCamera / dist;
+    vec3 u = normalize(cross(abs(w.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0), w));
+    vec3 v = cross(w, u);
+    float halfSize = radius * dist / sqrt(max(dist * dist - radius * radius, 1e-6));
+
+    RayTarget = center + (u * corner.x + v * corner.y) * halfSize;
+    gl_Position = projection * view * vec4(RayTarget, 1.0);
+}
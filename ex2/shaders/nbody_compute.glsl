@@ -0,0 +1,69 @@
+#version 430 core
+layout (local_size_x = 256) in;
+
+struct Particle
+{
+    vec4 position;  // xyz: 位置, w: GM
+    vec4 velocity;  // xyz: 速度, w: 渲染缩放
+};
+
+layout (std430, binding = 0) readonly buffer ParticlesIn { Particle src[]; };
+layout (std430, binding = 1) writeonly buffer ParticlesOut { Particle dst[]; };
+
+uniform int particleCount;
+uniform int attractorCount;
+uniform vec4 attractors[8];     // xyz: 位置, w: GM
+uniform float dt;
+uniform int mutualGravity;
+uniform float softening2;
+
+shared vec4 tile[256];
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    bool active = i < uint(particleCount);
+
+    float halfDt = 0.5 * dt;
+
+    // 漂移半步
+    vec3 p = active ? src[i].position.xyz + src[i].velocity.xyz * halfDt : vec3(0.0);
+    vec3 a = vec3(0.0);
+
+    // 太阳和行星
+    for (int k = 0; k < attractorCount; k++)
+    {
+        vec3 d = attractors[k].xyz - p;
+        float r2 = dot(d, d) + softening2;
+        a += d * (attractors[k].w / (r2 * sqrt(r2)));
+    }
+
+    // 粒子间相互引力：按工作组大小分块载入共享内存
+    if (mutualGravity != 0)
+    {
+        for (int base = 0; base < particleCount; base += 256)
+        {
+            uint j = uint(base) + gl_LocalInvocationID.x;
+            // 其他粒子的半步位置
+            tile[gl_LocalInvocationID.x] = j < uint(particleCount)
+                ? vec4(src[j].position.xyz + src[j].velocity.xyz * halfDt, src[j].position.w)
+                : vec4(0.0);
+            barrier();
+            for (int k = 0; k < 256; k++)
+            {
+                vec3 d = tile[k].xyz - p;
+                float r2 = dot(d, d) + softening2;
+                a += d * (tile[k].w / (r2 * sqrt(r2)));
+            }
+            barrier();
+        }
+    }
+
+    if (!active)
+        return;
+
+    // 漂移-踢-漂移蛙跳法，与CPU参考实现一致
+    vec3 v = src[i].velocity.xyz + a * dt;
+    dst[i].position = vec4(p + v * halfDt, src[i].position.w);
+    dst[i].velocity = vec4(v, src[i].velocity.w);
+}
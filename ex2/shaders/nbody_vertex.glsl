@@ -0,0 +1,30 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+
+struct Particle
+{
+    vec4 position;
+    vec4 velocity;
+};
+
+// 计算着色器输出的粒子状态，直接作为实例数据
+layout (std430, binding = 0) readonly buffer Particles { Particle particles[]; };
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 originOffset;  // 粒子坐标原点相对相机的位置，FragPos 在相机空间中
+
+void main()
+{
+    Particle p = particles[gl_InstanceID];
+    FragPos = p.position.xyz + originOffset + aPos * p.velocity.w;
+    Normal = aNormal;
+    TexCoord = aTexCoord;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
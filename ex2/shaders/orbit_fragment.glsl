@@ -0,0 +1,9 @@
+#version 330 core
+out vec4 FragColor;
+
+uniform vec3 orbitColor;
+
+void main()
+{
+    FragColor = vec4(orbitColor, 0.35);
+}
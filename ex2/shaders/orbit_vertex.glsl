@@ -0,0 +1,37 @@
+#version 330 core
+layout (location = 0) in vec4 aElements;    // 半长轴, 偏心率, 倾角, 升交点经度
+layout (location = 1) in vec2 aPeriapsis;   // 近心点幅角, 中心下标
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform int segments;
+uniform vec3 orbitCenters[MAX_ORBIT_CENTERS];   // 由程序按 OrbitPaths::MAX_CENTERS 定义
+
+const float PI = 3.14159265359;
+
+void main()
+{
+    float a = aElements.x;
+    float e = aElements.y;
+    float inclination = aElements.z;
+    float node = aElements.w;
+    float periapsis = aPeriapsis.x;
+
+    // 按偏心近点角均匀取点，轨道面内以近心点方向为 +X
+    float E = 2.0 * PI * float(gl_VertexID) / float(segments);
+    vec2 p = vec2(a * (cos(E) - e), a * sqrt(max(1.0 - e * e, 0.0)) * sin(E));
+
+    // 近心点幅角：在轨道面内旋转
+    float cw = cos(periapsis), sw = sin(periapsis);
+    p = vec2(cw * p.x - sw * p.y, sw * p.x + cw * p.y);
+
+    // 倾角：轨道面绕X轴倾斜（与程序中月球轨道的倾斜方式一致）
+    vec3 pos = vec3(p.x, p.y * sin(inclination), p.y * cos(inclination));
+
+    // 升交点经度：绕Y轴旋转
+    float cn = cos(node), sn = sin(node);
+    pos = vec3(cn * pos.x + sn * pos.z, pos.y, -sn * pos.x + cn * pos.z);
+
+    pos += orbitCenters[int(aPeriapsis.y)];
+    gl_Position = projection * view * vec4(pos, 1.0);
+}
@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 SpriteColor;
+
+void main()
+{
+    // 圆形点精灵
+    vec2 offset = gl_PointCoord * 2.0 - 1.0;
+    if (dot(offset, offset) > 1.0)
+        discard;
+    FragColor = vec4(SpriteColor, 1.0);
+}
@@ -0,0 +1,44 @@
+#version 430 core
+// 远处小行星的点精灵：每颗一个顶点，光照按整颗小球预先算好
+layout (location = 0) in uint aInstance;
+
+struct Particle
+{
+    vec4 position;
+    vec4 velocity;
+};
+
+layout (std430, binding = 0) readonly buffer Particles { Particle particles[]; };
+
+out vec3 SpriteColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 originOffset;  // 粒子坐标原点相对相机的位置
+uniform vec3 viewPos;
+uniform vec3 sunLightPos;
+uniform vec3 objectColor;
+uniform float meshRadius;
+uniform float viewportHeight;
+
+void main()
+{
+    Particle p = particles[aInstance];
+    vec3 pos = p.position.xyz + originOffset;
+    gl_Position = projection * view * vec4(pos, 1.0);
+
+    // 不足一个像素时保持一个像素大小，按覆盖面积降低亮度
+    float diameter = meshRadius * p.velocity.w * projection[1][1] * viewportHeight / gl_Position.w;
+    gl_PointSize = max(diameter, 1.0);
+    float coverage = min(diameter * diameter, 1.0);
+
+    // 整颗小球的平均亮度：环境光 + 从相机看到的被照亮比例（相位）× 漫反射均值（朗伯球约 2/3）
+    vec3 toSun = normalize(sunLightPos - pos);
+    vec3 toCamera = normalize(viewPos - pos);
+    float phase = 0.5 + 0.5 * dot(toSun, toCamera);
+    float distance = length(sunLightPos - pos);
+    float attenuation = 1.0 / (1.0 + 0.003 * distance + 0.00005 * distance * distance);
+    vec3 ambient = 0.15 * vec3(1.0, 1.0, 0.95);
+    vec3 diffuse = phase * 0.66 * vec3(1.8, 1.8, 1.7) * attenuation;
+    SpriteColor = (ambient + diffuse) * objectColor * coverage;
+}
@@ -0,0 +1,11 @@
+#version 330 core
+out vec4 FragColor;
+
+in float Fade;
+
+uniform vec3 trailColor;
+
+void main()
+{
+    FragColor = vec4(trailColor, Fade * 0.8);
+}
@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec4 aSample; // xyz: 位置, w: 采样时间
+
+out float Fade;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 originOffset;  // 采样以世界原点为基准，加上世界原点相对相机的位置
+uniform float currentTime;
+uniform float trailDuration;
+
+void main()
+{
+    // 越旧的采样越透明
+    Fade = clamp(1.0 - (currentTime - aSample.w) / trailDuration, 0.0, 1.0);
+    gl_Position = projection * view * vec4(aSample.xyz + originOffset, 1.0);
+}
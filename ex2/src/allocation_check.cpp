@@ -0,0 +1,109 @@
+#include "allocation_check.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<bool> tracking(false);
+    std::atomic<unsigned long long> allocationCount(0);
+    std::atomic<unsigned long long> allocationBytes(0);
+    std::atomic<size_t> firstSize(0);
+
+    void* allocate(size_t size)
+    {
+        if (tracking.load(std::memory_order_relaxed))
+        {
+            if (allocationCount.fetch_add(1, std::memory_order_relaxed) == 0)
+                firstSize.store(size, std::memory_order_relaxed);
+            allocationBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        return std::malloc(size ? size : 1);
+    }
+}
+
+void resetAllocationTracking()
+{
+    allocationCount = 0;
+    allocationBytes = 0;
+    firstSize = 0;
+}
+
+void setAllocationTracking(bool enabled)
+{
+    tracking = enabled;
+}
+
+unsigned long long trackedAllocations()
+{
+    return allocationCount;
+}
+
+unsigned long long trackedAllocationBytes()
+{
+    return allocationBytes;
+}
+
+size_t firstTrackedAllocationSize()
+{
+    return firstSize;
+}
+
+// ---- 全局 operator new/delete 替换 ----
+
+void* operator new(size_t size)
+{
+    void* p = allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    void* p = allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,18 @@
+#ifndef ALLOCATION_CHECK_H
+#define ALLOCATION_CHECK_H
+
+#include <cstddef>
+
+// 调试用的堆分配检查：allocation_check.cpp 替换了全局 operator new/delete，
+// 开启统计后记录所有线程经由 operator new 的分配次数与字节数（malloc 与驱动内部的分配不在其中）。
+// 未开启时每次分配只多一次原子读。--verify-no-alloc 用它确认渲染循环稳定后没有堆分配。
+
+void resetAllocationTracking();
+void setAllocationTracking(bool enabled);
+
+unsigned long long trackedAllocations();
+unsigned long long trackedAllocationBytes();
+// 统计期间第一次分配的大小，便于定位
+size_t firstTrackedAllocationSize();
+
+#endif // ALLOCATION_CHECK_H
@@ -0,0 +1,128 @@
+#include "asteroid_belt.h"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+    const double TWO_PI = 6.28318530717958647692;
+    // 整圈数不超过 14 位、相位高位只保留 10 位小数，两者乘积正好是 float 可精确表示的 24 位
+    const double MAX_REVOLUTIONS = 16383.0;
+    const double PHASE_HIGH_STEPS = 1024.0;
+}
+
+AsteroidBelt::AsteroidBelt()
+    : vao(0), instanceVBO(0), beltPeriod(1.0)
+{
+}
+
+AsteroidBelt::~AsteroidBelt()
+{
+    release();
+}
+
+void AsteroidBelt::generate(int count, float innerRadius, float outerRadius, double centralGM, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> radiusDist(innerRadius, outerRadius);
+    std::uniform_real_distribution<float> angleDist(0.0f, (float)TWO_PI);
+    std::normal_distribution<float> tiltDist(0.0f, 0.03f);
+    std::uniform_real_distribution<float> scaleDist(0.08f, 0.3f);
+
+    instances.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        BeltInstance& inst = instances[i];
+        inst.radius = radiusDist(rng);
+        inst.phase = angleDist(rng);
+        inst.inclination = tiltDist(rng);
+        inst.ascendingNode = angleDist(rng);
+        inst.scale = scaleDist(rng);
+    }
+
+    // 公共周期取最内侧（最快）轨道转 MAX_REVOLUTIONS 圈的时间，
+    // 每个小行星的角速度取整到周期内的整圈数，相对误差不超过 1/(2·MAX_REVOLUTIONS·(r_min/r_max)^1.5)
+    double fastest = std::sqrt(centralGM / ((double)innerRadius * innerRadius * innerRadius));
+    beltPeriod = MAX_REVOLUTIONS * TWO_PI / fastest;
+    for (BeltInstance& inst : instances)
+    {
+        double omega = std::sqrt(centralGM / ((double)inst.radius * inst.radius * inst.radius));
+        double turns = std::floor(omega * beltPeriod / TWO_PI + 0.5);
+        inst.revolutions = (float)std::min(std::max(turns, 1.0), MAX_REVOLUTIONS);
+        inst.angularSpeed = (float)(TWO_PI * inst.revolutions / beltPeriod);
+    }
+}
+
+void AsteroidBelt::upload(unsigned int meshVBO, unsigned int meshEBO)
+{
+    if (!vao)
+    {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &instanceVBO);
+    }
+
+    glBindVertexArray(vao);
+
+    // 网格属性，与主程序的球体布局一致
+    glBindBuffer(GL_ARRAY_BUFFER, meshVBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshEBO);
+
+    // 实例属性：(半径, 角速度, 相位, 倾角) 和 (升交点经度, 缩放, 整圈数)
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(BeltInstance), instances.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(BeltInstance), (void*)0);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(BeltInstance), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+
+    glBindVertexArray(0);
+}
+
+void AsteroidBelt::release()
+{
+    if (instanceVBO)
+        glDeleteBuffers(1, &instanceVBO);
+    if (vao)
+        glDeleteVertexArrays(1, &vao);
+    instanceVBO = vao = 0;
+}
+
+glm::vec2 AsteroidBelt::shaderPhase(double simTime) const
+{
+    double u = std::fmod(simTime, beltPeriod) / beltPeriod;
+    if (u < 0.0)
+        u += 1.0;
+    double high = std::floor(u * PHASE_HIGH_STEPS) / PHASE_HIGH_STEPS;
+    return glm::vec2((float)high, (float)(u - high));
+}
+
+void AsteroidBelt::draw(int indexCount)
+{
+    if (!vao || instances.empty())
+        return;
+
+    glBindVertexArray(vao);
+    glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, (GLsizei)instances.size());
+    glBindVertexArray(0);
+}
+
+glm::vec3 AsteroidBelt::instancePosition(const BeltInstance& inst, double time) const
+{
+    // 与 belt_vertex.glsl 相同的计算顺序：轨道面内位置 -> 绕X轴倾斜 -> 绕Y轴旋转
+    double u = std::fmod(time, beltPeriod) / beltPeriod;
+    double turns = inst.revolutions * u;
+    double angle = inst.phase + TWO_PI * (turns - std::floor(turns));
+    double px = inst.radius * std::cos(angle);
+    double pz = inst.radius * std::sin(angle);
+    glm::dvec3 pos(px, pz * std::sin(inst.inclination), pz * std::cos(inst.inclination));
+    double cn = std::cos(inst.ascendingNode), sn = std::sin(inst.ascendingNode);
+    return glm::vec3(glm::dvec3(cn * pos.x + sn * pos.z, pos.y, -sn * pos.x + cn * pos.z));
+}
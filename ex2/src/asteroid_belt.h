@@ -0,0 +1,62 @@
+#ifndef ASTEROID_BELT_H
+#define ASTEROID_BELT_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// 小行星带中单个小行星的圆轨道参数
+struct BeltInstance
+{
+    float radius;           // 轨道半径
+    float angularSpeed;     // 角速度（弧度/模拟秒），等于 2π·revolutions / 小行星带周期
+    float phase;            // 模拟时间 0 时的轨道角
+    float inclination;      // 轨道倾角（绕X轴）
+    float ascendingNode;    // 升交点经度（绕Y轴）
+    float scale;            // 小行星半径
+    float revolutions;      // 一个小行星带周期内转过的整圈数
+};
+
+// GPU驱动的小行星带：顶点着色器根据实例的轨道参数和每帧一个相位统一变量计算位置
+//
+// 实例数据只在生成时上传一次，之后不再上传，CPU每帧也不做任何逐实例计算。
+// 角速度量化为公共周期内的整圈数，所有小行星的位置以这个周期循环：
+// CPU 用双精度把模拟时间折算为周期内的比例，拆成高低两个 float 传给着色器，
+// 整圈数乘高位部分的结果可以用 float 精确表示，取小数后再加低位部分，任意长的模拟时间都不损失精度。
+// instancePosition() 是与着色器一致的CPU参考实现。
+class AsteroidBelt
+{
+public:
+    AsteroidBelt();
+    ~AsteroidBelt();
+
+    // 在 [innerRadius, outerRadius] 之间生成 count 个小行星，
+    // 角速度按开普勒第三定律 ω = sqrt(GM / r³) 计算
+    void generate(int count, float innerRadius, float outerRadius, double centralGM, unsigned int seed);
+
+    // 复用已有的网格VBO/EBO（位置、法线、纹理坐标交错存放，8个float）创建实例化VAO
+    void upload(unsigned int meshVBO, unsigned int meshEBO);
+    void release();
+
+    // 传给着色器的 orbitPhase：模拟时间在小行星带周期内的比例（高位, 低位）
+    glm::vec2 shaderPhase(double simTime) const;
+
+    // 实例化绘制，调用前需设置好着色器
+    void draw(int indexCount);
+
+    int instanceCount() const { return (int)instances.size(); }
+    const BeltInstance& instance(int i) const { return instances[i]; }
+    double period() const { return beltPeriod; }
+
+    // CPU参考实现：实例在模拟时间 time 的位置
+    glm::vec3 instancePosition(const BeltInstance& inst, double time) const;
+
+private:
+    unsigned int vao;
+    unsigned int instanceVBO;
+    std::vector<BeltInstance> instances;
+    double beltPeriod;      // 所有小行星回到初始位置的周期（模拟秒）
+};
+
+#endif // ASTEROID_BELT_H
@@ -0,0 +1,180 @@
+#include "benchmark.h"
+
+#include "asteroid_belt.h"
+#include "gl_ext.h"
+#include "gpu_nbody.h"
+#include "orbit_paths.h"
+#include "program_cache.h"
+#include "shader_variants.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 与主程序相同的小行星带和吸引体（太阳 + 地球）
+    void makeScenario(int count, std::vector<NBodyParticle>& particles, std::vector<NBodyAttractor>& attractors)
+    {
+        const double sunGM = 0.5 * 0.5 * 50.0 * 50.0 * 50.0;
+        AsteroidBelt belt;
+        belt.generate(count, 65.0f, 85.0f, sunGM, 7u);
+        particlesFromBelt(belt, 1e-3f, particles);
+
+        NBodyAttractor sun = { glm::vec3(0.0f), (float)sunGM };
+        NBodyAttractor earth = { glm::vec3(50.0f, 0.0f, 0.0f), 2.0f * 2.0f * 8.0f * 8.0f * 8.0f };
+        attractors.clear();
+        attractors.push_back(sun);
+        attractors.push_back(earth);
+    }
+
+    // 主程序启动时编译的图形程序（着色器对 + 特性组合）
+    // orbitDefine 为真时与主程序一样注入 OrbitPaths::shaderDefine()
+    struct StartupProgram { const char* vertex; const char* fragment; unsigned int features; bool orbitDefine; };
+    const StartupProgram STARTUP_PROGRAMS[] = {
+        { "shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl", LIGHTING_EMISSIVE | LIGHTING_TEXTURED, false },
+        { "shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl", LIGHTING_TEXTURED | LIGHTING_BACK_LIGHT, false },
+        { "shaders/impostor_vertex.glsl", "shaders/impostor_fragment.glsl", LIGHTING_EMISSIVE | LIGHTING_TEXTURED, false },
+        { "shaders/impostor_vertex.glsl", "shaders/impostor_fragment.glsl", LIGHTING_TEXTURED | LIGHTING_BACK_LIGHT, false },
+        { "shaders/belt_vertex.glsl", "shaders/fragment_shader.glsl", LIGHTING_BACK_LIGHT, false },
+        { "shaders/nbody_vertex.glsl", "shaders/fragment_shader.glsl", LIGHTING_BACK_LIGHT, false },
+        { "shaders/nbody_indirect_vertex.glsl", "shaders/fragment_shader.glsl", LIGHTING_BACK_LIGHT, false },
+        { "shaders/trail_vertex.glsl", "shaders/trail_fragment.glsl", 0, false },
+        { "shaders/orbit_vertex.glsl", "shaders/orbit_fragment.glsl", 0, true },
+        { "shaders/sprite_vertex.glsl", "shaders/sprite_fragment.glsl", 0, false },
+    };
+
+    // 依次构建全部启动程序，返回耗时（秒）；failed 统计构建失败的个数（3.3 上下文没有SSBO，N体相关的会失败）
+    double buildStartupPrograms(int& failed)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        failed = 0;
+        for (const StartupProgram& p : STARTUP_PROGRAMS)
+        {
+            ShaderVariants variants(p.vertex, p.fragment, LIGHTING_FEATURE_NAMES);
+            variants.addIncludeDir("../common/shaders");
+            if (p.orbitDefine)
+                variants.addDefine(OrbitPaths::shaderDefine());
+            if (!variants.get(p.features))
+                failed++;
+        }
+        return secondsSince(start);
+    }
+}
+
+int runComputeVerification(unsigned int computeProgram)
+{
+    if (!glCaps.computeShader)
+    {
+        printf("N-body compute verification: SKIPPED (OpenGL %d.%d has no compute shaders)\n", glCaps.major, glCaps.minor);
+        return 0;
+    }
+
+    std::vector<NBodyParticle> initial;
+    std::vector<NBodyAttractor> attractors;
+    makeScenario(2048, initial, attractors);
+
+    NBodyParams params = { 0.05f, 200, true, 0.05f };
+
+    std::vector<NBodyParticle> cpu = initial;
+    WorkerPool pool;
+    integrateNBodyCpu(cpu, attractors, params, &pool);
+
+    GpuNBody gpu;
+    if (!gpu.init(computeProgram, initial))
+    {
+        printf("N-body compute verification: FAILED (cannot create SSBOs)\n");
+        return 1;
+    }
+    gpu.step(attractors, params);
+    std::vector<NBodyParticle> result;
+    gpu.download(result);
+
+    // float 运算顺序与 FMA 的差异会随步数累积，按轨道半径给出相对容差
+    float maxError = 0.0f;
+    for (size_t i = 0; i < cpu.size(); i++)
+        maxError = std::max(maxError, glm::length(glm::vec3(cpu[i].position) - glm::vec3(result[i].position)));
+    const float tolerance = 85.0f * 1e-3f;
+    bool passed = maxError <= tolerance;
+    printf("N-body compute verification: %s (%zu bodies, %d steps, max position error %g, tolerance %g)\n",
+           passed ? "PASSED" : "FAILED", cpu.size(), params.substeps, maxError, tolerance);
+    return passed ? 0 : 1;
+}
+
+int runBenchmarks(unsigned int computeProgram)
+{
+    printf("OpenGL %d.%d, %s\n", glCaps.major, glCaps.minor, (const char*)glGetString(GL_RENDERER));
+
+    WorkerPool pool;
+    struct Case { const char* name; int count; bool mutual; int cpuSteps; int gpuSteps; };
+    const Case cases[] = {
+        { "orbit (sun + planets)", 262144, false, 4, 64 },
+        { "mutual N-body", 8192, true, 1, 16 },
+    };
+
+    printf("%-24s %10s %16s %16s\n", "N-body", "bodies", "CPU bodies/s", "GPU bodies/s");
+    for (const Case& c : cases)
+    {
+        std::vector<NBodyParticle> particles;
+        std::vector<NBodyAttractor> attractors;
+        makeScenario(c.count, particles, attractors);
+
+        NBodyParams params = { 0.05f, c.cpuSteps, c.mutual, 0.05f };
+        std::vector<NBodyParticle> cpu = particles;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        integrateNBodyCpu(cpu, attractors, params, &pool);
+        double cpuRate = (double)c.count * c.cpuSteps / secondsSince(start);
+
+        double gpuRate = 0.0;
+        GpuNBody gpu;
+        if (gpu.init(computeProgram, particles))
+        {
+            // 预热一次，排除着色器首次执行的开销
+            params.substeps = 1;
+            gpu.step(attractors, params);
+            glFinish();
+
+            params.substeps = c.gpuSteps;
+            start = std::chrono::steady_clock::now();
+            gpu.step(attractors, params);
+            glFinish();
+            gpuRate = (double)c.count * c.gpuSteps / secondsSince(start);
+        }
+
+        printf("%-24s %10d %16.3e %16.3e\n", c.name, c.count, cpuRate, gpuRate);
+    }
+
+    // 着色器程序构建：冷启动强制从源码编译且不写缓存（计时不含磁盘写入），
+    // 之后再构建一遍写入缓存，热启动从程序二进制缓存加载。
+    // 驱动自带的着色器缓存也可能让“冷启动”变快，两者之差是本缓存能省下的下限
+    const int programCount = (int)(sizeof(STARTUP_PROGRAMS) / sizeof(STARTUP_PROGRAMS[0]));
+    int failed = 0;
+    printf("\n%-24s %10s %16s\n", "Program build", "programs", "ms");
+    programBinaryCache.setLoadEnabled(false);
+    programBinaryCache.setStoreEnabled(false);
+    double cold = buildStartupPrograms(failed);
+    programBinaryCache.setStoreEnabled(true);
+    printf("%-24s %10d %16.2f\n", "cold (source)", programCount - failed, cold * 1000.0);
+    if (programBinaryCache.enabled())
+    {
+        // 不计时的一遍：从源码编译并写入缓存，保证热启动全部命中
+        buildStartupPrograms(failed);
+        programBinaryCache.setLoadEnabled(true);
+        size_t hitsBefore = programBinaryCache.hits;
+        double warm = buildStartupPrograms(failed);
+        printf("%-24s %10d %16.2f   (%zu cache hits)\n", "warm (binary cache)", programCount - failed, warm * 1000.0,
+               programBinaryCache.hits - hitsBefore);
+    }
+    else
+    {
+        printf("%-24s %10s %16s\n", "warm (binary cache)", "-", "unsupported");
+    }
+    return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// 命令行自检与基准测试，需要在OpenGL上下文创建之后调用；返回值作为进程退出码
+
+// --verify-compute：计算着色器N体积分与CPU参考积分器的结果对比
+int runComputeVerification(unsigned int computeProgram);
+
+// --benchmark：打印各项基准测试结果
+int runBenchmarks(unsigned int computeProgram);
+
+#endif // BENCHMARK_H
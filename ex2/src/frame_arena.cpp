@@ -0,0 +1,75 @@
+#include "frame_arena.h"
+
+#include <cstdint>
+
+namespace
+{
+    size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+FrameArena::FrameArena(size_t initialBytes)
+    : current(0), overflows(0)
+{
+    for (Half& half : halves)
+    {
+        half.base = new unsigned char[initialBytes];
+        half.size = initialBytes;
+        half.offset = 0;
+        half.overflowBytes = 0;
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    for (Half& half : halves)
+    {
+        for (unsigned char* block : half.overflow)
+            delete[] block;
+        delete[] half.base;
+    }
+}
+
+void FrameArena::beginFrame()
+{
+    current = 1 - current;
+    reset(halves[current]);
+}
+
+void FrameArena::reset(Half& half)
+{
+    if (!half.overflow.empty())
+    {
+        // 上次用这一半时超出了容量：合并成一个能装下全部内容的块，并留出余量
+        size_t needed = half.offset + half.overflowBytes;
+        for (unsigned char* block : half.overflow)
+            delete[] block;
+        half.overflow.clear();
+        delete[] half.base;
+        half.size = needed + needed / 2;
+        half.base = new unsigned char[half.size];
+    }
+    half.offset = 0;
+    half.overflowBytes = 0;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+    Half& half = halves[current];
+    // new[] 返回的块按 max_align_t 对齐，偏移量对齐即可
+    size_t start = alignUp(half.offset, alignment);
+    if (start + bytes <= half.size)
+    {
+        half.offset = start + bytes;
+        return half.base + start;
+    }
+
+    // 单独申请一块，本帧结束前一直有效
+    overflows++;
+    unsigned char* block = new unsigned char[bytes + alignment];
+    half.overflow.push_back(block);
+    half.overflowBytes += bytes + alignment;
+    return (void*)alignUp((uintptr_t)block, alignment);
+}
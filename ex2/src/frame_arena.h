@@ -0,0 +1,67 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 每帧的线性分配器：分配只移动偏移量，不逐个释放，帧开始时整体清空。
+//
+// 内部有两半轮换使用，beginFrame 切换到另一半并清空它，上一帧分配的内存在本帧仍然有效，
+// 交给其他线程的数据（如后台线程读取的任务参数）可以晚一帧使用而不必复制。
+// 容量不够时向系统申请额外的块，下次清空这一半时合并成一个更大的块，稳定后每帧不再有堆分配。
+// 只能在主线程上分配；放入的对象不会被析构，只能是可平凡析构的类型。
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t initialBytes = 256 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void beginFrame();
+
+    void* allocate(size_t bytes, size_t alignment = 16);
+
+    // 未初始化的数组
+    template <typename T>
+    T* allocArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // 本帧已分配的字节数与当前这一半的容量
+    size_t bytesUsed() const { return halves[current].offset + halves[current].overflowBytes; }
+    size_t capacity() const { return halves[current].size; }
+    // 容量不够而向系统申请额外块的次数（稳定运行时应不再增长）
+    unsigned long long overflowCount() const { return overflows; }
+
+private:
+    struct Half
+    {
+        unsigned char* base;
+        size_t size;
+        size_t offset;
+        std::vector<unsigned char*> overflow;
+        size_t overflowBytes;
+    };
+
+    void reset(Half& half);
+
+    Half halves[2];
+    int current;
+    unsigned long long overflows;
+};
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,181 @@
+#include "frame_pacer.h"
+
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "hud_overlay.h"
+#include "profiler.h"
+
+namespace
+{
+    const int64_t MIN_SPIN_MARGIN = 500000;        // 0.5ms
+    const int64_t MAX_SPIN_MARGIN = 20000000;      // 20ms
+}
+
+FramePacer::FramePacer()
+    : interval(0), deadline(0), spinMargin(2000000), lastPresent(0), swap(SWAP_DEFAULT),
+      historyCount(0), historyHead(0), samples(0), meanMs(0.0), m2(0.0), maxIntervalMs(0.0), missed(0)
+{
+    std::fill(intervalsMs, intervalsMs + HISTORY, 0.0f);
+}
+
+int64_t FramePacer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FramePacer::setTargetFps(double fps)
+{
+    interval = fps > 0.0 ? (int64_t)(1e9 / fps) : 0;
+    deadline = 0;
+}
+
+double FramePacer::targetFps() const
+{
+    return interval > 0 ? 1e9 / (double)interval : 0.0;
+}
+
+SwapMode FramePacer::setSwapMode(SwapMode mode)
+{
+    if (mode == SWAP_ADAPTIVE
+        && !glfwExtensionSupported("WGL_EXT_swap_control_tear")
+        && !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+    {
+        std::cout << "Adaptive vsync is not supported, using vsync" << std::endl;
+        mode = SWAP_VSYNC;
+    }
+
+    if (mode == SWAP_IMMEDIATE)
+        glfwSwapInterval(0);
+    else if (mode == SWAP_VSYNC)
+        glfwSwapInterval(1);
+    else if (mode == SWAP_ADAPTIVE)
+        glfwSwapInterval(-1);
+    swap = mode;
+    return swap;
+}
+
+void FramePacer::waitForNextFrame()
+{
+    if (interval <= 0)
+        return;
+
+    PROFILE_CPU("pace wait");
+    int64_t t = now();
+    if (deadline == 0 || t - deadline > interval)
+    {
+        // 第一帧或落后超过一帧：从现在重新对齐，不去追赶错过的帧
+        deadline = t;
+        return;
+    }
+
+    // 先睡眠到截止时刻前 spinMargin，根据实际醒来的时刻调整余量
+    int64_t sleepUntil = deadline - spinMargin;
+    if (sleepUntil > t)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(sleepUntil - t));
+        int64_t woke = now();
+        int64_t overshoot = woke - sleepUntil;
+        // 超时比余量大时立即放大，否则缓慢收缩
+        if (overshoot > spinMargin)
+            spinMargin = std::min(MAX_SPIN_MARGIN, overshoot + overshoot / 4);
+        else
+            spinMargin = std::max(MIN_SPIN_MARGIN, spinMargin - (spinMargin - overshoot) / 16);
+    }
+    while (now() < deadline)
+        std::this_thread::yield();
+}
+
+void FramePacer::framePresented()
+{
+    int64_t t = now();
+    if (interval > 0)
+        deadline = (deadline == 0 ? t : deadline) + interval;
+
+    if (lastPresent != 0)
+    {
+        double ms = (t - lastPresent) / 1e6;
+        intervalsMs[historyHead] = (float)ms;
+        historyHead = (historyHead + 1) % HISTORY;
+        historyCount = std::min(historyCount + 1, HISTORY);
+
+        samples++;
+        double delta = ms - meanMs;
+        meanMs += delta / samples;
+        m2 += delta * (ms - meanMs);
+        maxIntervalMs = std::max(maxIntervalMs, ms);
+        if (interval > 0 && ms > interval / 1e6 * 1.5)
+            missed++;
+    }
+    lastPresent = t;
+}
+
+void FramePacer::discontinuity()
+{
+    lastPresent = 0;
+    deadline = 0;
+}
+
+void FramePacer::recentIntervals(double* mean, double* jitter, double* maxMs) const
+{
+    double sum = 0.0, sumSq = 0.0, largest = 0.0;
+    for (int i = 0; i < historyCount; i++)
+    {
+        sum += intervalsMs[i];
+        sumSq += (double)intervalsMs[i] * intervalsMs[i];
+        largest = std::max(largest, (double)intervalsMs[i]);
+    }
+    double m = historyCount > 0 ? sum / historyCount : 0.0;
+    *mean = m;
+    *jitter = historyCount > 1 ? std::sqrt(std::max(0.0, sumSq / historyCount - m * m)) : 0.0;
+    *maxMs = largest;
+}
+
+float FramePacer::drawHud(HudOverlay& hud, float x, float y) const
+{
+    const glm::vec4 TEXT(0.9f, 0.9f, 0.9f, 1.0f);
+    const float line = hud.lineHeight();
+    const int LINES = 3;
+    hud.rect(x - 4.0f, y - 4.0f, hud.charWidth() * 34 + 8.0f, line * LINES + 8.0f, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+
+    static const char* const SWAP_NAMES[] = { "DEFAULT", "OFF", "VSYNC", "ADAPTIVE" };
+    double mean, jitter, largest;
+    recentIntervals(&mean, &jitter, &largest);
+    char text[64];
+    snprintf(text, sizeof(text), "PRESENT %6.2f MS  JITTER %5.2f", mean, jitter);
+    hud.text(x, y, text, TEXT);
+    snprintf(text, sizeof(text), "MAX     %6.2f MS  MISSED %6llu", largest, missed);
+    hud.text(x, y + line, text, TEXT);
+    if (interval > 0)
+        snprintf(text, sizeof(text), "TARGET  %6.1f FPS SWAP %s", targetFps(), SWAP_NAMES[swap]);
+    else
+        snprintf(text, sizeof(text), "TARGET  NONE       SWAP %s", SWAP_NAMES[swap]);
+    hud.text(x, y + line * 2, text, TEXT);
+    return y + line * LINES + 12.0f;
+}
+
+void FramePacer::printSummary() const
+{
+    if (samples == 0)
+        return;
+    double jitter = samples > 1 ? std::sqrt(m2 / (samples - 1)) : 0.0;
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(3)
+              << "Frame pacing: " << samples << " intervals, mean " << meanMs << " ms, jitter " << jitter
+              << " ms, max " << maxIntervalMs << " ms";
+    if (interval > 0)
+        std::cout << std::setprecision(1) << ", target " << targetFps() << " fps, " << missed << " missed";
+    std::cout << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
@@ -0,0 +1,75 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cstdint>
+
+class HudOverlay;
+
+// 交换间隔
+enum SwapMode
+{
+    SWAP_DEFAULT,       // 不设置，使用驱动默认值
+    SWAP_IMMEDIATE,     // 0：不等待垂直同步
+    SWAP_VSYNC,         // 1：等待垂直同步
+    SWAP_ADAPTIVE       // -1：按时完成的帧等待垂直同步，迟到的帧立即显示（需要 EXT_swap_control_tear）
+};
+
+// 帧率限制与帧间隔统计
+//
+// 设定目标帧率后，每帧在交换缓冲前等到预定的呈现时刻：先睡眠到截止时刻前一小段，再自旋到截止时刻。
+// 睡眠的实际超时随系统计时器精度不同（Windows 默认约 15ms），留给自旋的余量按实测的睡眠超时自适应调整。
+// 截止时刻按固定间隔递推而不是从本帧结束算起，不会累积漂移；落后超过一帧时重新对齐。
+//
+// 交换缓冲返回后记录呈现时刻，统计相邻两次呈现的间隔及其抖动（标准差）。
+// 时间使用 steady_clock 的整数纳秒，长时间运行也不会损失精度。
+class FramePacer
+{
+public:
+    FramePacer();
+
+    // fps <= 0 表示不限帧率
+    void setTargetFps(double fps);
+    double targetFps() const;
+
+    // 在创建上下文之后调用；自适应垂直同步不受支持时退回普通垂直同步，返回实际使用的模式
+    SwapMode setSwapMode(SwapMode mode);
+    SwapMode swapMode() const { return swap; }
+
+    // 交换缓冲前调用：未到本帧的呈现时刻时等待
+    void waitForNextFrame();
+    // 交换缓冲后调用
+    void framePresented();
+    // 主循环停顿过（如空闲等待）：下一次呈现间隔不计入统计，截止时刻重新对齐
+    void discontinuity();
+
+    // 最近 HISTORY 帧的呈现间隔平均值与标准差（毫秒）
+    void recentIntervals(double* meanMs, double* jitterMs, double* maxMs) const;
+
+    // 左上角 (x, y) 开始绘制帧间隔统计，返回下方空白处的 y
+    float drawHud(HudOverlay& hud, float x, float y) const;
+    void printSummary() const;
+
+private:
+    static const int HISTORY = 240;
+
+    static int64_t now();
+
+    int64_t interval;           // 目标帧间隔（纳秒），0 表示不限
+    int64_t deadline;           // 下一帧的呈现时刻
+    int64_t spinMargin;         // 截止时刻前停止睡眠、改为自旋的余量
+    int64_t lastPresent;        // 0 表示下一次呈现不计入统计
+    SwapMode swap;
+
+    float intervalsMs[HISTORY]; // 呈现间隔环形历史
+    int historyCount;
+    int historyHead;
+
+    // 全程统计（Welford 算法）
+    unsigned long long samples;
+    double meanMs;
+    double m2;
+    double maxIntervalMs;
+    unsigned long long missed;  // 超过目标间隔 1.5 倍的帧
+};
+
+#endif // FRAME_PACER_H
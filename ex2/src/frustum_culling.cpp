@@ -0,0 +1,195 @@
+#include "frustum_culling.h"
+
+#include "profiler.h"
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CULL_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULL_SIMD_WIDTH 4
+#else
+#define CULL_SIMD_WIDTH 1
+#endif
+
+Frustum extractFrustum(const glm::mat4& m, bool reversedZ)
+{
+    // glm 为列主序，m[列][行]
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum f;
+    f.planes[0] = row3 + row0;  // 左
+    f.planes[1] = row3 - row0;  // 右
+    f.planes[2] = row3 + row1;  // 下
+    f.planes[3] = row3 - row1;  // 上
+    if (reversedZ)
+    {
+        f.planes[4] = row3 - row2;  // 近：z <= w
+        f.planes[5] = row2;         // 远：z >= 0
+    }
+    else
+    {
+        f.planes[4] = row3 + row2;  // 近
+        f.planes[5] = row3 - row2;  // 远
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        float len = glm::length(glm::vec3(f.planes[i].x, f.planes[i].y, f.planes[i].z));
+        if (len > 0.0f)
+            f.planes[i] = f.planes[i] * (1.0f / len);
+    }
+    return f;
+}
+
+void BoundingSpheres::clear()
+{
+    resize(0);
+}
+
+void BoundingSpheres::resize(size_t n)
+{
+    count = n;
+    // 补齐到 8 的倍数，SIMD 路径可以整块读取
+    size_t padded = (n + 7) & ~(size_t)7;
+    x.resize(padded, 0.0f);
+    y.resize(padded, 0.0f);
+    z.resize(padded, 0.0f);
+    radius.resize(padded, 0.0f);
+}
+
+void BoundingSpheres::set(size_t index, const glm::vec3& center, float r)
+{
+    x[index] = center.x;
+    y[index] = center.y;
+    z[index] = center.z;
+    radius[index] = r;
+}
+
+void BoundingSpheres::add(const glm::vec3& center, float r)
+{
+    resize(count + 1);
+    set(count - 1, center, r);
+}
+
+bool sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        const glm::vec4& p = frustum.planes[i];
+        if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+size_t cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres,
+                   std::vector<uint32_t>& visible, CullStats* stats)
+{
+    PROFILE_CPU("frustum cull");
+    size_t n = spheres.size();
+    visible.resize(n);
+    uint32_t* out = visible.data();
+    size_t visibleCount = 0;
+    size_t i = 0;
+
+#if CULL_SIMD_WIDTH == 8
+    __m256 px[6], py[6], pz[6], pw[6];
+    for (int k = 0; k < 6; k++)
+    {
+        px[k] = _mm256_set1_ps(frustum.planes[k].x);
+        py[k] = _mm256_set1_ps(frustum.planes[k].y);
+        pz[k] = _mm256_set1_ps(frustum.planes[k].z);
+        pw[k] = _mm256_set1_ps(frustum.planes[k].w);
+    }
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (; i < n; i += 8)
+    {
+        __m256 cx = _mm256_loadu_ps(&spheres.x[i]);
+        __m256 cy = _mm256_loadu_ps(&spheres.y[i]);
+        __m256 cz = _mm256_loadu_ps(&spheres.z[i]);
+        __m256 negR = _mm256_sub_ps(zero, _mm256_loadu_ps(&spheres.radius[i]));
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int k = 0; k < 6; k++)
+        {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[k], cx), _mm256_mul_ps(py[k], cy)),
+                                     _mm256_add_ps(_mm256_mul_ps(pz[k], cz), pw[k]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+        }
+
+        unsigned int mask = (unsigned int)_mm256_movemask_ps(inside);
+        if (n - i < 8)
+            mask &= (1u << (n - i)) - 1u;
+        // 按位展开，把可见下标紧凑写出
+        while (mask)
+        {
+            unsigned int bit = 0;
+            while (!(mask & (1u << bit)))
+                bit++;
+            out[visibleCount++] = (uint32_t)(i + bit);
+            mask &= mask - 1;
+        }
+    }
+#elif CULL_SIMD_WIDTH == 4
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (int k = 0; k < 6; k++)
+    {
+        px[k] = _mm_set1_ps(frustum.planes[k].x);
+        py[k] = _mm_set1_ps(frustum.planes[k].y);
+        pz[k] = _mm_set1_ps(frustum.planes[k].z);
+        pw[k] = _mm_set1_ps(frustum.planes[k].w);
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i < n; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(&spheres.x[i]);
+        __m128 cy = _mm_loadu_ps(&spheres.y[i]);
+        __m128 cz = _mm_loadu_ps(&spheres.z[i]);
+        __m128 negR = _mm_sub_ps(zero, _mm_loadu_ps(&spheres.radius[i]));
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int k = 0; k < 6; k++)
+        {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[k], cx), _mm_mul_ps(py[k], cy)),
+                                  _mm_add_ps(_mm_mul_ps(pz[k], cz), pw[k]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+
+        unsigned int mask = (unsigned int)_mm_movemask_ps(inside);
+        if (n - i < 4)
+            mask &= (1u << (n - i)) - 1u;
+        while (mask)
+        {
+            unsigned int bit = 0;
+            while (!(mask & (1u << bit)))
+                bit++;
+            out[visibleCount++] = (uint32_t)(i + bit);
+            mask &= mask - 1;
+        }
+    }
+#else
+    for (; i < n; i++)
+    {
+        glm::vec3 c(spheres.x[i], spheres.y[i], spheres.z[i]);
+        if (sphereInFrustum(frustum, c, spheres.radius[i]))
+            out[visibleCount++] = (uint32_t)i;
+    }
+#endif
+
+    visible.resize(visibleCount);
+    if (stats)
+    {
+        stats->tested = n;
+        stats->visible = visibleCount;
+        stats->culled = n - visibleCount;
+    }
+    return visibleCount;
+}
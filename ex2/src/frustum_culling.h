@@ -0,0 +1,56 @@
+#ifndef FRUSTUM_CULLING_H
+#define FRUSTUM_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// 视锥体六个平面（法线指向内侧，已归一化）：左、右、下、上、近、远
+// 无限远投影的远平面法线为零、常数项为正，任何包围球都在其内侧
+struct Frustum
+{
+    glm::vec4 planes[6];
+};
+
+// 从 projection * view 提取视锥平面（Gribb-Hartmann 方法）
+// reversedZ 为 true 时裁剪空间深度为 [0, w]、近平面映射到 w（见 SceneTarget），否则为 [-w, w]
+Frustum extractFrustum(const glm::mat4& viewProjection, bool reversedZ = false);
+
+// 包围球集合，按分量分别连续存放（SoA），便于每次测试 8 个
+class BoundingSpheres
+{
+public:
+    void clear();
+    void resize(size_t count);
+    void set(size_t index, const glm::vec3& center, float radius);
+    void add(const glm::vec3& center, float radius);
+
+    size_t size() const { return count; }
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> radius;
+
+private:
+    size_t count = 0;
+};
+
+// 每帧的剔除统计
+struct CullStats
+{
+    size_t tested;
+    size_t visible;
+    size_t culled;
+};
+
+// 测试所有包围球，把可见的下标紧凑地写入 visible（会被清空），返回可见数量。
+// 启用 AVX 编译时每次测试 8 个球，否则使用 SSE（4 个）或标量路径。
+size_t cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres,
+                   std::vector<uint32_t>& visible, CullStats* stats = nullptr);
+
+// 标量参考实现
+bool sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius);
+
+#endif // FRUSTUM_CULLING_H
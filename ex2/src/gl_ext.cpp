@@ -0,0 +1,61 @@
+#include "gl_ext.h"
+
+#include <cstring>
+
+GLCapabilities glCaps = { 3, 3, false, false, false };
+
+#ifndef GL_VERSION_4_0
+PFNGLDRAWARRAYSINDIRECTPROC glext_DrawArraysIndirect = NULL;
+#endif
+
+#ifndef GL_VERSION_4_3
+PFNGLDISPATCHCOMPUTEPROC glext_DispatchCompute = NULL;
+PFNGLMEMORYBARRIERPROC glext_MemoryBarrier = NULL;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glext_MultiDrawElementsIndirect = NULL;
+#endif
+
+#ifndef GL_VERSION_4_5
+PFNGLCLIPCONTROLPROC glext_ClipControl = NULL;
+#endif
+
+bool hasGLExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if (ext && strcmp(ext, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+void loadGLExtensions(GLADloadproc load)
+{
+    glGetIntegerv(GL_MAJOR_VERSION, &glCaps.major);
+    glGetIntegerv(GL_MINOR_VERSION, &glCaps.minor);
+    int version = glCaps.major * 10 + glCaps.minor;
+
+#ifndef GL_VERSION_4_0
+    glext_DrawArraysIndirect = (PFNGLDRAWARRAYSINDIRECTPROC)load("glDrawArraysIndirect");
+#endif
+#ifndef GL_VERSION_4_3
+    glext_DispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)load("glDispatchCompute");
+    glext_MemoryBarrier = (PFNGLMEMORYBARRIERPROC)load("glMemoryBarrier");
+    glext_MultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)load("glMultiDrawElementsIndirect");
+#endif
+#ifndef GL_VERSION_4_5
+    glext_ClipControl = (PFNGLCLIPCONTROLPROC)load("glClipControl");
+#endif
+    glCaps.computeShader = (version >= 43
+                            || (hasGLExtension("GL_ARB_compute_shader")
+                                && hasGLExtension("GL_ARB_shader_storage_buffer_object")))
+                           && glDispatchCompute && glMemoryBarrier;
+    // 间接命令中的 baseInstance 需要 4.2 / ARB_base_instance 才会生效
+    glCaps.multiDrawIndirect = (version >= 43
+                                || (hasGLExtension("GL_ARB_multi_draw_indirect")
+                                    && hasGLExtension("GL_ARB_base_instance")))
+                               && glMultiDrawElementsIndirect && glDrawArraysIndirect;
+    glCaps.clipControl = (version >= 45 || hasGLExtension("GL_ARB_clip_control")) && glClipControl;
+}
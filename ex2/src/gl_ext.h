@@ -0,0 +1,76 @@
+#ifndef GL_EXT_H
+#define GL_EXT_H
+
+#include <glad/glad.h>
+
+// glad 只生成了 OpenGL 3.3 Core 的函数，这里在运行时按需加载更高版本的入口。
+// 若以后重新生成了包含这些版本的 glad，对应的 #ifndef 分支会自动跳过。
+
+// 当前上下文的版本与可选功能
+struct GLCapabilities
+{
+    int major;
+    int minor;
+    bool computeShader;     // GL 4.3 或 ARB_compute_shader + ARB_shader_storage_buffer_object
+    bool multiDrawIndirect; // GL 4.3 或 ARB_multi_draw_indirect + ARB_base_instance
+    bool clipControl;       // GL 4.5 或 ARB_clip_control
+};
+
+extern GLCapabilities glCaps;
+
+// 在 gladLoadGLLoader 之后调用
+void loadGLExtensions(GLADloadproc load);
+bool hasGLExtension(const char* name);
+
+// ---- GL 4.2 / 4.3：计算着色器与SSBO ----
+#ifndef GL_VERSION_4_3
+#define GL_COMPUTE_SHADER                   0x91B9
+#define GL_SHADER_STORAGE_BUFFER            0x90D2
+#define GL_SHADER_STORAGE_BARRIER_BIT       0x00002000
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT  0x00000001
+#define GL_BUFFER_UPDATE_BARRIER_BIT        0x00000200
+
+typedef void (APIENTRYP PFNGLDISPATCHCOMPUTEPROC)(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+typedef void (APIENTRYP PFNGLMEMORYBARRIERPROC)(GLbitfield barriers);
+
+extern PFNGLDISPATCHCOMPUTEPROC glext_DispatchCompute;
+extern PFNGLMEMORYBARRIERPROC glext_MemoryBarrier;
+
+#define glDispatchCompute glext_DispatchCompute
+#define glMemoryBarrier glext_MemoryBarrier
+#endif
+
+// ---- GL 4.0 / 4.3：间接绘制 ----
+#ifndef GL_VERSION_4_0
+#define GL_DRAW_INDIRECT_BUFFER             0x8F3F
+
+typedef void (APIENTRYP PFNGLDRAWARRAYSINDIRECTPROC)(GLenum mode, const void* indirect);
+
+extern PFNGLDRAWARRAYSINDIRECTPROC glext_DrawArraysIndirect;
+
+#define glDrawArraysIndirect glext_DrawArraysIndirect
+#endif
+
+#ifndef GL_VERSION_4_3
+#define GL_COMMAND_BARRIER_BIT              0x00000040
+
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+extern PFNGLMULTIDRAWELEMENTSINDIRECTPROC glext_MultiDrawElementsIndirect;
+
+#define glMultiDrawElementsIndirect glext_MultiDrawElementsIndirect
+#endif
+
+// ---- GL 4.5：裁剪空间深度范围 ----
+#ifndef GL_VERSION_4_5
+#define GL_NEGATIVE_ONE_TO_ONE              0x935E
+#define GL_ZERO_TO_ONE                      0x935F
+
+typedef void (APIENTRYP PFNGLCLIPCONTROLPROC)(GLenum origin, GLenum depth);
+
+extern PFNGLCLIPCONTROLPROC glext_ClipControl;
+
+#define glClipControl glext_ClipControl
+#endif
+
+#endif // GL_EXT_H
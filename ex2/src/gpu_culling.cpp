@@ -0,0 +1,213 @@
+#include "gpu_culling.h"
+#include "frustum_culling.h"
+#include "gl_ext.h"
+#include "profiler.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+GpuInstanceCuller::GpuInstanceCuller()
+    : program(0), commandBuffer(0), spriteCommandBuffer(0), visibleBuffer(0), vao(0), spriteVAO(0),
+      hiZTexture(0), hiZLevels(0), hiZWidth(0), hiZHeight(0), capacity(0), spritePixels(3.0f)
+{
+}
+
+GpuInstanceCuller::~GpuInstanceCuller()
+{
+    release();
+}
+
+bool GpuInstanceCuller::init(unsigned int cullProgram, unsigned int meshVBO, unsigned int meshEBO,
+                             const std::vector<MeshLod>& lods, int maxInstances)
+{
+    release();
+    if (!glCaps.computeShader || !glCaps.multiDrawIndirect || !cullProgram)
+        return false;
+    if (lods.empty() || (int)lods.size() > MAX_LODS || maxInstances <= 0)
+    {
+        std::cout << "ERROR::GPU_CULLING::INVALID_LODS" << std::endl;
+        return false;
+    }
+
+    program = cullProgram;
+    capacity = maxInstances;
+    commands.resize(lods.size());
+    lodDistances.resize(lods.size());
+    for (size_t i = 0; i < lods.size(); i++)
+    {
+        commands[i].count = lods[i].indexCount;
+        commands[i].instanceCount = 0;
+        commands[i].firstIndex = lods[i].firstIndex;
+        commands[i].baseVertex = lods[i].baseVertex;
+        commands[i].baseInstance = (unsigned int)(i * capacity);
+        lodDistances[i] = lods[i].maxDistance;
+    }
+
+    glGenBuffers(1, &commandBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand),
+                 commands.data(), GL_DYNAMIC_DRAW);
+
+    DrawArraysIndirectCommand spriteCommand = { 0, 1, 0, 0 };
+    glGenBuffers(1, &spriteCommandBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, spriteCommandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(spriteCommand), &spriteCommand, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    glGenBuffers(1, &visibleBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (lods.size() + 1) * capacity * sizeof(unsigned int), NULL, GL_DYNAMIC_COPY);
+
+    // 网格属性来自共享网格，location = 3 为逐实例的粒子下标
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, meshVBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(unsigned int), (void*)0);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshEBO);
+    glBindVertexArray(0);
+
+    // 点精灵每个顶点就是一颗小行星，下标从最后一段读取
+    glGenVertexArrays(1, &spriteVAO);
+    glBindVertexArray(spriteVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+    glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(unsigned int),
+                           (void*)(lods.size() * capacity * sizeof(unsigned int)));
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenTextures(1, &hiZTexture);
+    glBindTexture(GL_TEXTURE_2D, hiZTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+void GpuInstanceCuller::release()
+{
+    if (commandBuffer)
+        glDeleteBuffers(1, &commandBuffer);
+    if (spriteCommandBuffer)
+        glDeleteBuffers(1, &spriteCommandBuffer);
+    if (visibleBuffer)
+        glDeleteBuffers(1, &visibleBuffer);
+    if (vao)
+        glDeleteVertexArrays(1, &vao);
+    if (spriteVAO)
+        glDeleteVertexArrays(1, &spriteVAO);
+    if (hiZTexture)
+        glDeleteTextures(1, &hiZTexture);
+    commandBuffer = spriteCommandBuffer = visibleBuffer = vao = spriteVAO = hiZTexture = 0;
+    hiZLevels = hiZWidth = hiZHeight = 0;
+    commands.clear();
+}
+
+void GpuInstanceCuller::uploadHiZ(const OcclusionCuller& occlusion)
+{
+    if (!hiZTexture)
+        return;
+
+    glBindTexture(GL_TEXTURE_2D, hiZTexture);
+    bool resized = occlusion.width() != hiZWidth || occlusion.height() != hiZHeight;
+    int levels = 0;
+    for (int l = 0; l < occlusion.levelCount(); l++)
+    {
+        // GL的第 l 级尺寸为 max(1, w >> l)，CPU层级按向上取整缩小，奇数尺寸时两者不同
+        int w = std::max(1, occlusion.width() >> l);
+        int h = std::max(1, occlusion.height() >> l);
+        if (w != occlusion.levelWidth(l) || h != occlusion.levelHeight(l))
+            break;
+        if (resized)
+            glTexImage2D(GL_TEXTURE_2D, l, GL_R32F, w, h, 0, GL_RED, GL_FLOAT, occlusion.depth(l));
+        else
+            glTexSubImage2D(GL_TEXTURE_2D, l, 0, 0, w, h, GL_RED, GL_FLOAT, occlusion.depth(l));
+        levels++;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::max(0, levels - 1));
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    hiZLevels = levels;
+    hiZWidth = occlusion.width();
+    hiZHeight = occlusion.height();
+}
+
+void GpuInstanceCuller::cull(const glm::mat4& view, const glm::vec3& originOffset, const glm::mat4& projection,
+                             float nearPlane, bool reversedZ, int instanceCount, float meshRadius, float viewportHeight)
+{
+    PROFILE_CPU("cull dispatch");
+    if (!commandBuffer)
+        return;
+    instanceCount = std::min(instanceCount, capacity);
+
+    // 重置各级的实例数
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+    DrawArraysIndirectCommand spriteCommand = { 0, 1, 0, 0 };
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, spriteCommandBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(spriteCommand), &spriteCommand);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    Frustum frustum = extractFrustum(projection * view, reversedZ);
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "instanceCount"), instanceCount);
+    glUniform1f(glGetUniformLocation(program, "meshRadius"), meshRadius);
+    glUniform4fv(glGetUniformLocation(program, "frustumPlanes"), 6, glm::value_ptr(frustum.planes[0]));
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniform3fv(glGetUniformLocation(program, "originOffset"), 1, glm::value_ptr(originOffset));
+    glUniform2f(glGetUniformLocation(program, "focal"), projection[0][0], projection[1][1]);
+    glUniform1f(glGetUniformLocation(program, "nearPlane"), nearPlane);
+    glUniform1i(glGetUniformLocation(program, "lodCount"), (int)commands.size());
+    glUniform1fv(glGetUniformLocation(program, "lodDistances"), (GLsizei)lodDistances.size(), lodDistances.data());
+    glUniform1f(glGetUniformLocation(program, "viewportHeight"), viewportHeight);
+    glUniform1f(glGetUniformLocation(program, "spritePixels"), spritePixels);
+    glUniform1ui(glGetUniformLocation(program, "spriteBase"), (GLuint)(commands.size() * capacity));
+    glUniform1i(glGetUniformLocation(program, "hiZLevels"), hiZLevels);
+    glUniform1i(glGetUniformLocation(program, "hiZ"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, hiZTexture);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, visibleBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, spriteCommandBuffer);
+    glDispatchCompute((GLuint)((instanceCount + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE), 1, 1);
+    // 间接命令和实例属性都由计算着色器写入
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void GpuInstanceCuller::draw()
+{
+    if (!commandBuffer)
+        return;
+    glBindVertexArray(vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, (GLsizei)commands.size(), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void GpuInstanceCuller::drawSprites()
+{
+    if (!spriteCommandBuffer)
+        return;
+    glBindVertexArray(spriteVAO);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, spriteCommandBuffer);
+    glDrawArraysIndirect(GL_POINTS, (void*)0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,100 @@
+#ifndef GPU_CULLING_H
+#define GPU_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "occlusion_culling.h"
+
+// 同一网格的一级细节：在共享 VBO/EBO 中的索引范围，及使用该级的最远距离
+struct MeshLod
+{
+    unsigned int indexCount;
+    unsigned int firstIndex;
+    int baseVertex;
+    float maxDistance;      // 超过最后一级的距离时改为点精灵
+};
+
+// 与 glMultiDrawElementsIndirect 读取的命令布局一致
+struct DrawElementsIndirectCommand
+{
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int firstIndex;
+    int baseVertex;
+    unsigned int baseInstance;
+};
+
+// 与 glDrawArraysIndirect 读取的命令布局一致
+struct DrawArraysIndirectCommand
+{
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int first;
+    unsigned int baseInstance;
+};
+
+// GPU驱动的实例剔除：计算着色器对 binding = 0 的粒子SSBO逐实例做视锥剔除、
+// 层级Z遮挡剔除和LOD选择，把可见实例下标按LOD分段写入缓冲并累加间接命令的实例数，
+// 绘制时一个材质只需一次 glMultiDrawElementsIndirect，CPU不接触任何实例数据。
+//
+// 可见下标作为 divisor = 1 的整数顶点属性（location = 3）送入顶点着色器，
+// 实例属性的读取会加上 baseInstance，因此不需要 gl_BaseInstance（GL 4.6）。
+//
+// 投影直径小于 spritePixels 像素的实例（以及超过最后一级LOD距离的实例）进入最低一档：
+// 作为点精灵批量绘制，每颗只有一个顶点，光照在顶点着色器中按整颗小球预先算好。
+class GpuInstanceCuller
+{
+public:
+    static const int MAX_LODS = 4;
+    static const int WORK_GROUP_SIZE = 256;
+
+    GpuInstanceCuller();
+    ~GpuInstanceCuller();
+
+    // cullProgram 由 createComputeProgram("shaders/cull_compute.glsl") 创建；
+    // meshVBO/meshEBO 按 位置/法线/纹理坐标 交错存放所有LOD
+    bool init(unsigned int cullProgram, unsigned int meshVBO, unsigned int meshEBO,
+              const std::vector<MeshLod>& lods, int maxInstances);
+    void release();
+
+    // 把CPU构建的层级Z上传为纹理；尺寸不符合GL多级纹理规则时只使用能对应上的层级
+    void uploadHiZ(const OcclusionCuller& occlusion);
+
+    // 剔除当前绑定在 binding = 0 的粒子（GpuNBody::bindForDraw 之后调用）
+    // meshRadius 为网格包围球半径，乘以粒子的渲染缩放得到实例包围球
+    // viewportHeight 为帧缓冲高度（像素），用于计算投影直径；reversedZ 为投影的深度约定（见 extractFrustum）
+    // view 只含旋转，originOffset 为粒子坐标原点相对相机的位置，二者把粒子变换到相机空间
+    void cull(const glm::mat4& view, const glm::vec3& originOffset, const glm::mat4& projection, float nearPlane, bool reversedZ,
+              int instanceCount, float meshRadius, float viewportHeight);
+
+    // 绘制全部网格LOD，调用前需使用好着色器程序
+    void draw();
+    // 绘制点精灵档，调用前需使用好 sprite_vertex.glsl 程序并启用 GL_PROGRAM_POINT_SIZE
+    void drawSprites();
+
+    void setSpritePixels(float pixels) { spritePixels = pixels; }
+    float getSpritePixels() const { return spritePixels; }
+
+    bool isReady() const { return commandBuffer != 0; }
+    int lodCount() const { return (int)commands.size(); }
+
+private:
+    unsigned int program;
+    unsigned int commandBuffer;     // GL_DRAW_INDIRECT_BUFFER，同时作为SSBO写入
+    unsigned int spriteCommandBuffer;
+    unsigned int visibleBuffer;     // 每级LOD和点精灵档各占 capacity 个下标
+    unsigned int vao;
+    unsigned int spriteVAO;
+    unsigned int hiZTexture;
+    int hiZLevels;
+    int hiZWidth;
+    int hiZHeight;
+    int capacity;
+    float spritePixels;
+    std::vector<DrawElementsIndirectCommand> commands;  // 每帧重置用的模板（instanceCount = 0）
+    std::vector<float> lodDistances;
+};
+
+#endif // GPU_CULLING_H
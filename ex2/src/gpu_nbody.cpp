@@ -0,0 +1,172 @@
+#include "gpu_nbody.h"
+
+#include "gl_ext.h"
+#include "profiler.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+void particlesFromBelt(const AsteroidBelt& belt, float particleGM, std::vector<NBodyParticle>& out)
+{
+    const float HALF_PI = 1.57079632679f;
+    out.resize(belt.instanceCount());
+    for (int i = 0; i < belt.instanceCount(); i++)
+    {
+        const BeltInstance& inst = belt.instance(i);
+        glm::vec3 pos = belt.instancePosition(inst, 0.0);
+
+        // 圆轨道速度 = ω × 位置旋转90度，旋转变换是线性的，可直接复用位置公式
+        BeltInstance ahead = inst;
+        ahead.phase += HALF_PI;
+        ahead.radius *= inst.angularSpeed;
+        glm::vec3 vel = belt.instancePosition(ahead, 0.0);
+
+        out[i].position = glm::vec4(pos, particleGM);
+        out[i].velocity = glm::vec4(vel, inst.scale);
+    }
+}
+
+namespace
+{
+    void integrateRange(const std::vector<NBodyParticle>& src, std::vector<NBodyParticle>& dst,
+                        const std::vector<NBodyAttractor>& attractors, const NBodyParams& params,
+                        size_t begin, size_t end)
+    {
+        float eps2 = params.softening * params.softening;
+        float halfDt = 0.5f * params.dt;
+        for (size_t i = begin; i < end; i++)
+        {
+            // 漂移半步
+            glm::vec3 p = glm::vec3(src[i].position) + glm::vec3(src[i].velocity) * halfDt;
+            glm::vec3 a(0.0f);
+            for (const NBodyAttractor& at : attractors)
+            {
+                glm::vec3 d = at.position - p;
+                float r2 = glm::dot(d, d) + eps2;
+                a += d * (at.gm / (r2 * std::sqrt(r2)));
+            }
+            if (params.mutualGravity)
+            {
+                for (size_t j = 0; j < src.size(); j++)
+                {
+                    glm::vec3 d = glm::vec3(src[j].position) + glm::vec3(src[j].velocity) * halfDt - p;
+                    float r2 = glm::dot(d, d) + eps2;
+                    a += d * (src[j].position.w / (r2 * std::sqrt(r2)));
+                }
+            }
+
+            // 整步速度更新，再漂移半步
+            glm::vec3 v = glm::vec3(src[i].velocity) + a * params.dt;
+            dst[i].position = glm::vec4(p + v * halfDt, src[i].position.w);
+            dst[i].velocity = glm::vec4(v, src[i].velocity.w);
+        }
+    }
+}
+
+void integrateNBodyCpu(std::vector<NBodyParticle>& particles, const std::vector<NBodyAttractor>& attractors,
+                       const NBodyParams& params, WorkerPool* pool)
+{
+    std::vector<NBodyParticle> next(particles.size());
+    for (int s = 0; s < params.substeps; s++)
+    {
+        if (pool)
+        {
+            pool->parallelFor(particles.size(), [&](size_t begin, size_t end) {
+                integrateRange(particles, next, attractors, params, begin, end);
+            });
+        }
+        else
+        {
+            integrateRange(particles, next, attractors, params, 0, particles.size());
+        }
+        particles.swap(next);
+    }
+}
+
+GpuNBody::GpuNBody()
+    : program(0), current(0), count(0)
+{
+    buffers[0] = buffers[1] = 0;
+}
+
+GpuNBody::~GpuNBody()
+{
+    release();
+}
+
+bool GpuNBody::init(unsigned int computeProgram, const std::vector<NBodyParticle>& particles)
+{
+    release();
+    if (!glCaps.computeShader || !computeProgram)
+        return false;
+
+    program = computeProgram;
+    count = (int)particles.size();
+    current = 0;
+
+    glGenBuffers(2, buffers);
+    for (int i = 0; i < 2; i++)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[i]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, particles.size() * sizeof(NBodyParticle),
+                     particles.data(), GL_DYNAMIC_COPY);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return true;
+}
+
+void GpuNBody::release()
+{
+    if (buffers[0])
+        glDeleteBuffers(2, buffers);
+    buffers[0] = buffers[1] = 0;
+    count = 0;
+}
+
+void GpuNBody::step(const std::vector<NBodyAttractor>& attractors, const NBodyParams& params)
+{
+    PROFILE_CPU("nbody dispatch");
+    if (!count)
+        return;
+
+    int attractorCount = std::min((int)attractors.size(), MAX_ATTRACTORS);
+    glm::vec4 packed[MAX_ATTRACTORS];
+    for (int i = 0; i < attractorCount; i++)
+        packed[i] = glm::vec4(attractors[i].position, attractors[i].gm);
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "particleCount"), count);
+    glUniform1i(glGetUniformLocation(program, "attractorCount"), attractorCount);
+    if (attractorCount > 0)
+        glUniform4fv(glGetUniformLocation(program, "attractors"), attractorCount, glm::value_ptr(packed[0]));
+    glUniform1f(glGetUniformLocation(program, "dt"), params.dt);
+    glUniform1i(glGetUniformLocation(program, "mutualGravity"), params.mutualGravity ? 1 : 0);
+    glUniform1f(glGetUniformLocation(program, "softening2"), params.softening * params.softening);
+
+    GLuint groups = (GLuint)((count + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE);
+    for (int s = 0; s < params.substeps; s++)
+    {
+        // 读 current，写另一个缓冲；相互引力需要所有粒子的旧位置，不能原地更新
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffers[current]);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffers[1 - current]);
+        glDispatchCompute(groups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        current = 1 - current;
+    }
+}
+
+void GpuNBody::bindForDraw()
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffers[current]);
+}
+
+void GpuNBody::download(std::vector<NBodyParticle>& out)
+{
+    out.resize(count);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[current]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(NBodyParticle), out.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
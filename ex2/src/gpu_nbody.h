@@ -0,0 +1,73 @@
+#ifndef GPU_NBODY_H
+#define GPU_NBODY_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "asteroid_belt.h"
+#include "worker_pool.h"
+
+// 粒子状态，布局与计算着色器中的 std430 结构一致
+struct NBodyParticle
+{
+    glm::vec4 position;     // xyz: 位置, w: 引力参数 GM（互相吸引时使用）
+    glm::vec4 velocity;     // xyz: 速度, w: 渲染缩放
+};
+
+// 大质量吸引体（太阳、行星），每帧由CPU更新
+struct NBodyAttractor
+{
+    glm::vec3 position;
+    float gm;
+};
+
+// 积分参数，CPU与GPU共用
+struct NBodyParams
+{
+    float dt;
+    int substeps;
+    bool mutualGravity;     // 是否计算粒子之间的相互引力（O(N²)）
+    float softening;        // 引力软化长度
+};
+
+// 由小行星带的圆轨道参数生成初始粒子（epoch 时刻的位置和轨道速度）
+void particlesFromBelt(const AsteroidBelt& belt, float particleGM, std::vector<NBodyParticle>& out);
+
+// CPU参考积分器：漂移-踢-漂移蛙跳法（二阶辛积分），与计算着色器的计算顺序一致
+// 相互引力所需的其他粒子半步位置可由其旧状态直接算出，因此每个子步只需一次遍历
+void integrateNBodyCpu(std::vector<NBodyParticle>& particles, const std::vector<NBodyAttractor>& attractors,
+                       const NBodyParams& params, WorkerPool* pool);
+
+// 计算着色器积分：粒子状态常驻两个SSBO（读/写交替），
+// 实例化绘制直接从SSBO读取位置，没有任何CPU回读
+class GpuNBody
+{
+public:
+    static const int MAX_ATTRACTORS = 8;
+    static const int WORK_GROUP_SIZE = 256;
+
+    GpuNBody();
+    ~GpuNBody();
+
+    // computeProgram 由 createComputeProgram("shaders/nbody_compute.glsl") 创建
+    bool init(unsigned int computeProgram, const std::vector<NBodyParticle>& particles);
+    void release();
+
+    void step(const std::vector<NBodyAttractor>& attractors, const NBodyParams& params);
+
+    // 把当前状态绑定到 binding = 0 的SSBO，供 nbody_vertex.glsl 读取
+    void bindForDraw();
+    // 仅用于正确性验证
+    void download(std::vector<NBodyParticle>& out);
+
+    int particleCount() const { return count; }
+
+private:
+    unsigned int program;
+    unsigned int buffers[2];
+    int current;            // 当前状态所在的缓冲
+    int count;
+};
+
+#endif // GPU_NBODY_H
@@ -0,0 +1,192 @@
+#include "hud_overlay.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+namespace
+{
+    // 每个字形 5 行 x 3 列，从左上角起按行排列，最高位为第一行第一列
+    const unsigned short FONT_GLYPHS[64] = {
+        0x0000, 0x2482, 0x5A00, 0x5F7D, 0x3C9E, 0x42A1, 0x2AAB, 0x2400,
+        0x1491, 0x4494, 0x0AA8, 0x05D0, 0x0014, 0x01C0, 0x0002, 0x12A4,
+        0x7B6F, 0x2C97, 0x73E7, 0x72CF, 0x5BC9, 0x79CF, 0x79EF, 0x7252,
+        0x7BEF, 0x7BCF, 0x0410, 0x0414, 0x1511, 0x0E38, 0x4454, 0x72C2,
+        0x7BE3, 0x2BED, 0x6BAE, 0x3923, 0x6B6E, 0x79A7, 0x79A4, 0x396B,
+        0x5BED, 0x7497, 0x126A, 0x5BAD, 0x4927, 0x5FED, 0x6B6D, 0x2B6A,
+        0x6BA4, 0x2B73, 0x6BAD, 0x388E, 0x7492, 0x5B6F, 0x5B6A, 0x5BFD,
+        0x5AAD, 0x5A92, 0x72A7, 0x6926, 0x4889, 0x324B, 0x2A00, 0x0007,
+    };
+
+    const int FIRST_CHAR = 32;
+    const int GLYPH_COUNT = 64;
+    const int CELL_WIDTH = 4;       // 字形右侧和下方各留一像素空隙，放大后相邻格不会互相采样
+    const int CELL_HEIGHT = 6;
+    const int ATLAS_COLUMNS = 16;
+    const int ATLAS_WIDTH = ATLAS_COLUMNS * CELL_WIDTH;
+    const int ATLAS_HEIGHT = 5 * CELL_HEIGHT;   // 64 个字形 + 第 65 格为实心块
+    const int SOLID_CELL = GLYPH_COUNT;
+}
+
+HudOverlay::HudOverlay()
+    : vao(0), vbo(0), fontTexture(0), vboCapacity(0), scale(2.0f)
+{
+}
+
+HudOverlay::~HudOverlay()
+{
+    release();
+}
+
+void HudOverlay::init(float pixelScale)
+{
+    release();
+    scale = pixelScale;
+    // 预留足够的顶点，显示内容变化时不在渲染循环中重新分配
+    vertices.reserve(8192);
+
+    std::vector<unsigned char> atlas(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+    for (int glyph = 0; glyph <= SOLID_CELL; glyph++)
+    {
+        int cellX = (glyph % ATLAS_COLUMNS) * CELL_WIDTH;
+        int cellY = (glyph / ATLAS_COLUMNS) * CELL_HEIGHT;
+        for (int row = 0; row < CELL_HEIGHT; row++)
+        {
+            for (int col = 0; col < CELL_WIDTH; col++)
+            {
+                bool on;
+                if (glyph == SOLID_CELL)
+                    on = true;
+                else
+                    on = row < 5 && col < 3 && (FONT_GLYPHS[glyph] >> (14 - row * 3 - col)) & 1;
+                atlas[(cellY + row) * ATLAS_WIDTH + cellX + col] = on ? 255 : 0;
+            }
+        }
+    }
+
+    glGenTextures(1, &fontTexture);
+    glBindTexture(GL_TEXTURE_2D, fontTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, atlas.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // 位置 + 纹理坐标，颜色为归一化的 RGBA8
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+}
+
+void HudOverlay::release()
+{
+    if (vbo)
+        glDeleteBuffers(1, &vbo);
+    if (vao)
+        glDeleteVertexArrays(1, &vao);
+    if (fontTexture)
+        glDeleteTextures(1, &fontTexture);
+    vbo = vao = fontTexture = 0;
+    vboCapacity = 0;
+    vertices.clear();
+}
+
+void HudOverlay::quad(float x, float y, float width, float height, float u0, float v0, float u1, float v1, const glm::vec4& color)
+{
+    Vertex corner;
+    for (int i = 0; i < 4; i++)
+        corner.color[i] = (unsigned char)(glm::clamp(color[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+
+    // 两个三角形，不用索引
+    const float px[6] = { x, x + width, x + width, x, x + width, x };
+    const float py[6] = { y, y, y + height, y, y + height, y + height };
+    const float pu[6] = { u0, u1, u1, u0, u1, u0 };
+    const float pv[6] = { v0, v0, v1, v0, v1, v1 };
+    for (int i = 0; i < 6; i++)
+    {
+        corner.x = px[i];
+        corner.y = py[i];
+        corner.u = pu[i];
+        corner.v = pv[i];
+        vertices.push_back(corner);
+    }
+}
+
+void HudOverlay::text(float x, float y, const char* str, const glm::vec4& color)
+{
+    const float glyphWidth = 3.0f * scale;
+    const float glyphHeight = 5.0f * scale;
+    float startX = x;
+    for (; *str; str++)
+    {
+        int c = (unsigned char)*str;
+        if (c == '\n')
+        {
+            x = startX;
+            y += lineHeight();
+            continue;
+        }
+        if (c >= 'a' && c <= 'z')
+            c -= 'a' - 'A';
+        if (c != ' ' && c >= FIRST_CHAR && c < FIRST_CHAR + GLYPH_COUNT)
+        {
+            int glyph = c - FIRST_CHAR;
+            float u0 = (float)((glyph % ATLAS_COLUMNS) * CELL_WIDTH) / ATLAS_WIDTH;
+            float v0 = (float)((glyph / ATLAS_COLUMNS) * CELL_HEIGHT) / ATLAS_HEIGHT;
+            quad(x, y, glyphWidth, glyphHeight, u0, v0, u0 + 3.0f / ATLAS_WIDTH, v0 + 5.0f / ATLAS_HEIGHT, color);
+        }
+        x += charWidth();
+    }
+}
+
+void HudOverlay::rect(float x, float y, float width, float height, const glm::vec4& color)
+{
+    if (width <= 0.0f || height <= 0.0f)
+        return;
+    // 四个角都取实心格的中心
+    float u = ((SOLID_CELL % ATLAS_COLUMNS) * CELL_WIDTH + CELL_WIDTH * 0.5f) / ATLAS_WIDTH;
+    float v = ((SOLID_CELL / ATLAS_COLUMNS) * CELL_HEIGHT + CELL_HEIGHT * 0.5f) / ATLAS_HEIGHT;
+    quad(x, y, width, height, u, v, u, v, color);
+}
+
+void HudOverlay::draw(unsigned int program, int viewportWidth, int viewportHeight)
+{
+    if (!program || vertices.empty() || !vao)
+    {
+        vertices.clear();
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    if (vertices.size() > vboCapacity)
+        vboCapacity = std::max(vertices.size(), vboCapacity * 2);
+    // 每帧重新分配（丢弃旧存储），驱动不必等上一帧的绘制完成
+    glBufferData(GL_ARRAY_BUFFER, vboCapacity * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "viewportSize"), (float)viewportWidth, (float)viewportHeight);
+    glUniform1i(glGetUniformLocation(program, "fontAtlas"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, fontTexture);
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size());
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+
+    vertices.clear();
+}
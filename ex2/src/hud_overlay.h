@@ -0,0 +1,50 @@
+#ifndef HUD_OVERLAY_H
+#define HUD_OVERLAY_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// 屏幕叠加层：等宽像素字体的文字和纯色矩形（性能数据显示）
+//
+// 内置 3x5 点阵字体（ASCII 32~95，小写字母按大写显示），打包成一张 64x30 的单通道纹理，
+// 纯色矩形采样其中全白的一格，所以文字和矩形共用一个程序、一次绘制。
+// text/rect 只往 CPU 数组追加顶点，draw 时整批上传到动态顶点缓冲后清空。
+// 坐标以窗口左上角为原点，单位为像素。
+class HudOverlay
+{
+public:
+    HudOverlay();
+    ~HudOverlay();
+
+    // 需要 GL 上下文；scale 为字体像素的放大倍数
+    void init(float scale = 2.0f);
+    void release();
+
+    void text(float x, float y, const char* str, const glm::vec4& color);
+    void rect(float x, float y, float width, float height, const glm::vec4& color);
+
+    float charWidth() const { return 4.0f * scale; }
+    float lineHeight() const { return 7.0f * scale; }
+
+    // 用 hud_vertex/hud_fragment 程序绘制本帧追加的内容；program 为 0 时只清空
+    void draw(unsigned int program, int viewportWidth, int viewportHeight);
+
+private:
+    struct Vertex
+    {
+        float x, y, u, v;
+        unsigned char color[4];
+    };
+
+    void quad(float x, float y, float width, float height, float u0, float v0, float u1, float v1, const glm::vec4& color);
+
+    unsigned int vao;
+    unsigned int vbo;
+    unsigned int fontTexture;
+    size_t vboCapacity;     // 顶点数
+    float scale;
+    std::vector<Vertex> vertices;
+};
+
+#endif // HUD_OVERLAY_H
@@ -0,0 +1,84 @@
+#include "idle_mode.h"
+
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+#include "hud_overlay.h"
+
+IdleMode::IdleMode()
+    : enabledFlag(true), dirty(true), frameStart(0.0), frames(0), waits(0), active(0.0), idle(0.0)
+{
+}
+
+double IdleMode::waitForEvents(GLFWwindow* window, double timeout)
+{
+    double start = glfwGetTime();
+    waits++;
+    // 鼠标进入、获得焦点等不影响画面的事件也会唤醒，继续等待
+    while (!dirty && !glfwWindowShouldClose(window))
+    {
+        if (timeout < 0.0)
+        {
+            glfwWaitEvents();
+            continue;
+        }
+        double remaining = timeout - (glfwGetTime() - start);
+        if (remaining <= 0.0)
+            break;
+        glfwWaitEventsTimeout(remaining);
+    }
+    double waited = glfwGetTime() - start;
+    idle += waited;
+    return waited;
+}
+
+void IdleMode::beginFrame()
+{
+    frameStart = glfwGetTime();
+    // 这一帧会画出此前的所有变化；之后回调里的 invalidate 保留到帧结束
+    dirty = false;
+}
+
+void IdleMode::endFrame(bool changed)
+{
+    active += glfwGetTime() - frameStart;
+    frames++;
+    // 帧内 glfwPollEvents 触发的 invalidate（如 F1、窗口大小变化）不能被覆盖掉
+    dirty = dirty || changed;
+}
+
+float IdleMode::drawHud(HudOverlay& hud, float x, float y) const
+{
+    const glm::vec4 TEXT(0.9f, 0.9f, 0.9f, 1.0f);
+    const float line = hud.lineHeight();
+    const int LINES = 2;
+    hud.rect(x - 4.0f, y - 4.0f, hud.charWidth() * 34 + 8.0f, line * LINES + 8.0f, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+
+    double total = active + idle;
+    char text[64];
+    snprintf(text, sizeof(text), "IDLE %5.1f%%  WAKEUPS %8llu", total > 0.0 ? idle * 100.0 / total : 0.0, waits);
+    hud.text(x, y, text, TEXT);
+    snprintf(text, sizeof(text), "ACTIVE FPS %7.1f  AVG %7.1f",
+             active > 0.0 ? frames / active : 0.0, total > 0.0 ? frames / total : 0.0);
+    hud.text(x, y + line, text, TEXT);
+    return y + line * LINES + 12.0f;
+}
+
+void IdleMode::printSummary() const
+{
+    double total = active + idle;
+    if (total <= 0.0)
+        return;
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(1)
+              << "Idle mode: " << frames << " frames in " << active << " s active ("
+              << (active > 0.0 ? frames / active : 0.0) << " fps), " << idle << " s idle ("
+              << idle * 100.0 / total << "%) over " << waits << " waits, average " << frames / total << " fps" << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
@@ -0,0 +1,52 @@
+#ifndef IDLE_MODE_H
+#define IDLE_MODE_H
+
+struct GLFWwindow;
+class HudOverlay;
+
+// 按需渲染：场景和相机都没有变化时不再重绘，阻塞等待事件，窗口保留上一帧的画面
+//
+// 每帧结束时由主循环报告本帧是否有变化（模拟推进、回放解码、相机移动、着色器还在编译等），
+// 没有变化时下一帧开始前阻塞在 glfwWaitEventsTimeout，直到输入或窗口事件调用 invalidate，
+// 或者到达下一次已知的场景变化时刻（如回放的下一帧）。
+// 同时统计渲染与空闲的时间，活跃时间占比近似反映 CPU/GPU 的功耗。
+class IdleMode
+{
+public:
+    IdleMode();
+
+    void setEnabled(bool enabled) { enabledFlag = enabled; }
+    bool enabled() const { return enabledFlag; }
+
+    // 需要重绘（输入、窗口事件等），可在 GLFW 回调中调用
+    void invalidate() { dirty = true; }
+    bool needsFrame() const { return dirty || !enabledFlag; }
+
+    // 阻塞直到 invalidate 被调用、窗口要求关闭或经过 timeout 秒（小于 0 表示不限时），返回等待的秒数
+    double waitForEvents(GLFWwindow* window, double timeout);
+
+    // 渲染一帧的开始与结束；changed 表示本帧场景或相机有变化，下一帧还需要重绘。
+    // beginFrame 与 endFrame 之间调用的 invalidate 同样让下一帧重绘
+    void beginFrame();
+    void endFrame(bool changed);
+
+    unsigned long long renderedFrames() const { return frames; }
+    unsigned long long wakeups() const { return waits; }
+    double activeSeconds() const { return active; }
+    double idleSeconds() const { return idle; }
+
+    // 左上角 (x, y) 开始绘制空闲统计，返回下方空白处的 y
+    float drawHud(HudOverlay& hud, float x, float y) const;
+    void printSummary() const;
+
+private:
+    bool enabledFlag;
+    bool dirty;
+    double frameStart;
+    unsigned long long frames;
+    unsigned long long waits;
+    double active;              // 渲染帧耗费的时间（秒）
+    double idle;                // 阻塞等待的时间（秒）
+};
+
+#endif // IDLE_MODE_H
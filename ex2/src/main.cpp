@@ -5,24 +5,57 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "../external/stb/bmp_loader.h"
+#include "allocation_check.h"
+#include "asteroid_belt.h"
+#include "benchmark.h"
+#include "frame_arena.h"
+#include "frame_pacer.h"
+#include "frustum_culling.h"
+#include "gl_ext.h"
+#include "gpu_culling.h"
+#include "gpu_nbody.h"
+#include "hud_overlay.h"
+#include "idle_mode.h"
+#include "occlusion_culling.h"
+#include "orbit_paths.h"
+#include "orbit_trails.h"
+#include "profiler.h"
+#include "program_cache.h"
+#include "recording.h"
+#include "render_queue.h"
+#include "render_stats.h"
+#include "resource_files.h"
+#include "scene_graph.h"
+#include "scene_target.h"
+#include "shader_variants.h"
+#include "simulation.h"
+#include "worker_pool.h"
+#include "world_positions.h"
+
+#ifdef EMBED_RESOURCES
+#include "embedded_resources.h"
+#endif
 
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 
 // 窗口设置
 const unsigned int SCR_WIDTH = 1280;
 const unsigned int SCR_HEIGHT = 720;
 
-// 相机设置
-glm::vec3 cameraPos = glm::vec3(0.0f, 50.0f, 150.0f);
+// 相机设置（位置为双精度世界坐标，天体按相对相机的坐标渲染，见 world_positions.h）
+glm::dvec3 cameraPos = glm::dvec3(0.0, 50.0, 150.0);
 glm::vec3 cameraFront = glm::vec3(0.0f, -0.3f, -1.0f);
 glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
 
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
+// 帧时间用双精度，长时间运行后 glfwGetTime 的值仍保留亚毫秒精度
+double deltaTime = 0.0;
+double lastFrame = 0.0;
 
 // 鼠标设置
 float lastX = SCR_WIDTH / 2.0f;
@@ -31,29 +64,144 @@ bool firstMouse = true;
 float yaw = -90.0f;
 float pitch = -17.0f;
 
-// 速度控制
+// 速度控制（时间加速倍率）
 float speedMultiplier = 1.0f;
+const float MIN_SPEED_MULTIPLIER = 0.1f;
+const float MAX_SPEED_MULTIPLIER = 1e7f;
+// 暂停（P 键）：模拟、回放和轨迹线都停止推进，相机仍可移动
+bool simulationPaused = false;
+
+// 近平面距离；投影没有远平面（见 SceneTarget）
+const float NEAR_PLANE = 0.1f;
+// 渲染队列排序用的距离映射 d / (d + SORT_DISTANCE_SCALE)，任意远的天体都不会挤在同一个排序键上
+const float SORT_DISTANCE_SCALE = 100.0f;
+
+// 性能叠加层（F1 切换）
+bool showHud = false;
+
+// 按需渲染：输入与窗口事件回调中标记需要重绘
+IdleMode idleMode;
 
 // 函数声明
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void window_refresh_callback(GLFWwindow* window);
 void processInput(GLFWwindow *window);
 std::string readShaderFile(const char* filePath);
-unsigned int createShaderProgram(const char* vertexPath, const char* fragmentPath);
+std::vector<ShaderStage> loadShaderStages(const char* vertexPath, const char* fragmentPath);
+std::vector<ShaderStage> loadComputeStage(const char* computePath);
 void createSphere(std::vector<float>& vertices, std::vector<unsigned int>& indices, int segments = 20);
 unsigned int loadTexture(const char* path);
 
-int main()
+int main(int argc, char** argv)
 {
+    // 命令行参数：--record <文件> 录制模拟过程，--replay <文件> 回放录制文件，
+    // --asteroids <数量> 小行星带规模，--no-compute 禁用计算着色器，--nbody-mutual 小行星相互引力，
+    // --no-gpu-cull 小行星不使用GPU剔除与间接绘制，--sprite-pixels <像素> 小行星改为点精灵的投影直径，
+    // --mesh-spheres 天体用细分网格而不是光线求交替身，--no-shader-cache 不使用程序二进制缓存，
+    // --no-reversed-z 使用传统深度（默认在支持 glClipControl 时使用反向Z浮点深度），
+    // --no-idle 画面没有变化时也持续重绘（默认阻塞等待事件），
+    // --fps <帧率> 限制帧率并均匀呈现，--vsync off|on|adaptive 设置交换间隔（默认由驱动决定），
+    // --gpu-budget <毫秒> 打开动态分辨率并设置场景 GPU 时间预算（默认关闭），
+    // --min-res-scale <比例> 动态分辨率的最低比例（默认 0.5），
+    // --resource-dir <目录> 优先从该目录读取着色器和纹理（覆盖编译进程序的资源），
+    // --stats-log <文件> 把每帧渲染统计写入日志（.csv 为文本，否则为二进制），--stats-interval <帧数> 日志间隔，
+    // --verify-compute / --benchmark 运行自检或基准测试后退出，
+    // --verify-no-alloc 检查渲染循环稳定后是否还有堆分配（返回码表示是否通过）
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    int asteroidCount = 20000;
+    bool allowCompute = true;
+    bool mutualGravity = false;
+    bool allowGpuCulling = true;
+    float spritePixels = 3.0f;
+    bool useImpostors = true;
+    bool allowReversedZ = true;
+    bool allowIdle = true;
+    double targetFps = 0.0;
+    SwapMode swapMode = SWAP_DEFAULT;
+    float gpuBudgetMs = 0.0f;
+    float minResolutionScale = 0.5f;
+    bool useShaderCache = true;
+    bool verifyCompute = false;
+    bool benchmark = false;
+    bool verifyNoAlloc = false;
+    const char* statsLogPath = NULL;
+    int statsInterval = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--asteroids") == 0 && i + 1 < argc)
+            asteroidCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-compute") == 0)
+            allowCompute = false;
+        else if (strcmp(argv[i], "--nbody-mutual") == 0)
+            mutualGravity = true;
+        else if (strcmp(argv[i], "--no-gpu-cull") == 0)
+            allowGpuCulling = false;
+        else if (strcmp(argv[i], "--sprite-pixels") == 0 && i + 1 < argc)
+            spritePixels = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--mesh-spheres") == 0)
+            useImpostors = false;
+        else if (strcmp(argv[i], "--no-shader-cache") == 0)
+            useShaderCache = false;
+        else if (strcmp(argv[i], "--no-reversed-z") == 0)
+            allowReversedZ = false;
+        else if (strcmp(argv[i], "--no-idle") == 0)
+            allowIdle = false;
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            targetFps = atof(argv[++i]);
+        else if (strcmp(argv[i], "--gpu-budget") == 0 && i + 1 < argc)
+            gpuBudgetMs = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--min-res-scale") == 0 && i + 1 < argc)
+            minResolutionScale = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--vsync") == 0 && i + 1 < argc)
+        {
+            const char* mode = argv[++i];
+            if (strcmp(mode, "off") == 0)
+                swapMode = SWAP_IMMEDIATE;
+            else if (strcmp(mode, "on") == 0)
+                swapMode = SWAP_VSYNC;
+            else if (strcmp(mode, "adaptive") == 0)
+                swapMode = SWAP_ADAPTIVE;
+        }
+        else if (strcmp(argv[i], "--resource-dir") == 0 && i + 1 < argc)
+            setResourceOverrideDir(argv[++i]);
+        else if (strcmp(argv[i], "--stats-log") == 0 && i + 1 < argc)
+            statsLogPath = argv[++i];
+        else if (strcmp(argv[i], "--stats-interval") == 0 && i + 1 < argc)
+            statsInterval = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--verify-compute") == 0)
+            verifyCompute = true;
+        else if (strcmp(argv[i], "--benchmark") == 0)
+            benchmark = true;
+        else if (strcmp(argv[i], "--verify-no-alloc") == 0)
+            verifyNoAlloc = true;
+    }
+
+    // 着色器和纹理编译进了程序时，启动时不再读取磁盘
+#ifdef EMBED_RESOURCES
+    registerEmbeddedResources(EMBEDDED_RESOURCES, EMBEDDED_RESOURCE_COUNT);
+#endif
+
     // 初始化GLFW
     glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    // 创建窗口
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Sun-Earth-Moon System", NULL, NULL);
+    // 创建窗口：优先 4.5 上下文（计算着色器等功能），不支持时退回 3.3
+    const int contextVersions[][2] = { { 4, 5 }, { 4, 3 }, { 3, 3 } };
+    GLFWwindow* window = NULL;
+    for (int i = 0; i < 3 && window == NULL; i++)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, contextVersions[i][0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, contextVersions[i][1]);
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Sun-Earth-Moon System", NULL, NULL);
+    }
     if (window == NULL)
     {
         std::cout << "Failed to create GLFW window" << std::endl;
@@ -61,9 +209,16 @@ int main()
         return -1;
     }
     glfwMakeContextCurrent(window);
+
+    // 帧率限制与交换间隔
+    FramePacer framePacer;
+    framePacer.setSwapMode(swapMode);
+    framePacer.setTargetFps(targetFps);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
 
     // 捕获鼠标
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
@@ -74,12 +229,114 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+
+    // 渲染统计：替换绘制、绑定、uniform、上传相关的 GL 入口，每帧计数
+    renderStats.install();
+    if (statsLogPath)
+        renderStats.openLog(statsLogPath, statsInterval);
+
+    // 程序二进制缓存：第二次启动起跳过着色器编译；放在用户缓存目录，与启动时的工作目录无关
+    if (useShaderCache)
+        programBinaryCache.init((GLADloadproc)glfwGetProcAddress, ProgramBinaryCache::defaultDirectory("SunEarthMoon-ex2"));
+
+    // 着色器程序异步构建：启动时先发出全部编译和链接，之后网格、纹理、小行星带的初始化与驱动编译并行。
+    // 渲染循环每帧取已就绪的程序，还没就绪的绘制在该帧跳过
+    ProgramBuilder programBuilder;
+    programBuilder.init((GLADloadproc)glfwGetProcAddress);
+    double shaderBuildStart = glfwGetTime();
+
+    // 计算着色器N体积分（需要 GL 4.3）
+    int nbodyComputeBuild = -1;
+    if (glCaps.computeShader && (allowCompute || verifyCompute || benchmark))
+        nbodyComputeBuild = programBuilder.submit(loadComputeStage("shaders/nbody_compute.glsl"));
+
+    if (verifyCompute || benchmark)
+    {
+        unsigned int nbodyComputeProgram = programBuilder.wait(nbodyComputeBuild);
+        int result = 0;
+        if (verifyCompute)
+            result |= runComputeVerification(nbodyComputeProgram);
+        if (benchmark)
+            result |= runBenchmarks(nbodyComputeProgram);
+        glfwTerminate();
+        return result;
+    }
 
     // 配置OpenGL状态
     glEnable(GL_DEPTH_TEST);
 
+    // 场景渲染目标：支持时使用反向Z浮点深度，一遍深度覆盖从近平面到无限远
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    SceneTarget sceneTarget;
+    sceneTarget.init(allowReversedZ, framebufferWidth, framebufferHeight);
+    std::cout << "Depth: " << (sceneTarget.reversedZ() ? "reversed-Z float, infinite far plane" : "standard, infinite far plane") << std::endl;
+    // 动态分辨率（--gpu-budget 打开）：场景按 GPU 时间缩放渲染尺寸，叠加层保持原生分辨率。
+    // 启用分析器时各遍已占用 GL_TIME_ELAPSED 查询，场景 GPU 时间改从分析器读取
+    bool sceneGpuTimer = true;
+#ifdef ENABLE_PROFILER
+    sceneGpuTimer = false;
+    const char* const SCENE_PASSES[] = { "bodies", "asteroids", "orbits", "trails", "resolve" };
+#endif
+    if (gpuBudgetMs > 0.0f)
+        sceneTarget.enableDynamicResolution(gpuBudgetMs, minResolutionScale, sceneGpuTimer);
+    if (sceneTarget.dynamicResolution())
+        std::cout << "Dynamic resolution: " << gpuBudgetMs << " ms GPU budget, minimum scale " << minResolutionScale << std::endl;
+    else
+        std::cout << "Dynamic resolution: off" << std::endl;
+
     // 创建着色器程序
-    unsigned int shaderProgram = createShaderProgram("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl");
+    // 使用共用光照（common/shaders/lighting.glsl）的着色器按特性组合编译变体，第一次使用时才编译。
+    // 构建时 lighting.glsl 会复制到 shaders/，直接在源码目录运行时从 ../common/shaders 查找
+    const char* SHARED_SHADER_DIR = "../common/shaders";
+    ShaderVariants bodyShaders("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl", LIGHTING_FEATURE_NAMES);
+    ShaderVariants impostorShaders("shaders/impostor_vertex.glsl", "shaders/impostor_fragment.glsl", LIGHTING_FEATURE_NAMES);
+    ShaderVariants beltShaders("shaders/belt_vertex.glsl", "shaders/fragment_shader.glsl", LIGHTING_FEATURE_NAMES);
+    ShaderVariants nbodyShaders("shaders/nbody_vertex.glsl", "shaders/fragment_shader.glsl", LIGHTING_FEATURE_NAMES);
+    ShaderVariants nbodyIndirectShaders("shaders/nbody_indirect_vertex.glsl", "shaders/fragment_shader.glsl", LIGHTING_FEATURE_NAMES);
+    bodyShaders.addIncludeDir(SHARED_SHADER_DIR);
+    impostorShaders.addIncludeDir(SHARED_SHADER_DIR);
+    beltShaders.addIncludeDir(SHARED_SHADER_DIR);
+    nbodyShaders.addIncludeDir(SHARED_SHADER_DIR);
+    nbodyIndirectShaders.addIncludeDir(SHARED_SHADER_DIR);
+    bodyShaders.setBuilder(&programBuilder);
+    impostorShaders.setBuilder(&programBuilder);
+    beltShaders.setBuilder(&programBuilder);
+    nbodyShaders.setBuilder(&programBuilder);
+    nbodyIndirectShaders.setBuilder(&programBuilder);
+    // 替身写入的深度与裁剪空间深度约定一致
+    if (sceneTarget.reversedZ())
+        impostorShaders.addDefine("DEPTH_ZERO_TO_ONE");
+    const unsigned int SUN_FEATURES = LIGHTING_EMISSIVE | LIGHTING_TEXTURED;
+    const unsigned int PLANET_FEATURES = LIGHTING_TEXTURED | LIGHTING_BACK_LIGHT;
+    const unsigned int ROCK_FEATURES = LIGHTING_BACK_LIGHT;
+
+    // 这里的 get 只是提交构建，返回值在编译完成前为 0
+    ShaderVariants& bodyVariants = useImpostors ? impostorShaders : bodyShaders;
+    bodyVariants.get(SUN_FEATURES);
+    bodyVariants.get(PLANET_FEATURES);
+    beltShaders.get(ROCK_FEATURES);
+    int trailBuild = programBuilder.submit(loadShaderStages("shaders/trail_vertex.glsl", "shaders/trail_fragment.glsl"));
+    // orbitCenters 数组长度与 OrbitPaths::MAX_CENTERS 保持一致
+    std::vector<ShaderStage> orbitStages = loadShaderStages("shaders/orbit_vertex.glsl", "shaders/orbit_fragment.glsl");
+    orbitStages[0].source = preprocessShader(orbitStages[0].path,
+                                             { OrbitPaths::shaderDefine() },
+                                             std::vector<std::string>());
+    int orbitBuild = programBuilder.submit(orbitStages);
+    if (nbodyComputeBuild >= 0)
+        nbodyShaders.get(ROCK_FEATURES);
+    int cullComputeBuild = -1;
+    int spriteBuild = -1;
+    if (nbodyComputeBuild >= 0 && glCaps.multiDrawIndirect && allowGpuCulling)
+    {
+        cullComputeBuild = programBuilder.submit(loadComputeStage("shaders/cull_compute.glsl"));
+        nbodyIndirectShaders.get(ROCK_FEATURES);
+        spriteBuild = programBuilder.submit(loadShaderStages("shaders/sprite_vertex.glsl", "shaders/sprite_fragment.glsl"));
+        glEnable(GL_PROGRAM_POINT_SIZE);
+    }
+    int hudBuild = programBuilder.submit(loadShaderStages("shaders/hud_vertex.glsl", "shaders/hud_fragment.glsl"));
+    bool shadersReady = false;
 
     // 创建球体网格（使用较低的细分以提高性能）
     std::vector<float> vertices;
@@ -112,119 +369,769 @@ int main()
 
     int indexCount = indices.size();
 
+    glBindVertexArray(0);
+
+    // 球体替身的四边形由 gl_VertexID 生成，只需要一个空VAO
+    unsigned int impostorVAO;
+    glGenVertexArrays(1, &impostorVAO);
+
+    // 小行星网格（6段低多边形球体），后面依次附加 4 段、3 段的低细节版本供GPU剔除选择
+    std::vector<float> rockVertices;
+    std::vector<unsigned int> rockIndices;
+    const int ROCK_LOD_SEGMENTS[] = { 6, 4, 3 };
+    const float ROCK_LOD_DISTANCES[] = { 60.0f, 160.0f, 400.0f };
+    std::vector<MeshLod> rockLods;
+    for (int i = 0; i < 3; i++)
+    {
+        MeshLod lod;
+        lod.firstIndex = (unsigned int)rockIndices.size();
+        lod.baseVertex = (int)(rockVertices.size() / 8);
+        createSphere(rockVertices, rockIndices, ROCK_LOD_SEGMENTS[i]);
+        lod.indexCount = (unsigned int)rockIndices.size() - lod.firstIndex;
+        lod.maxDistance = ROCK_LOD_DISTANCES[i];
+        rockLods.push_back(lod);
+    }
+
+    unsigned int rockVBO, rockEBO;
+    glGenBuffers(1, &rockVBO);
+    glGenBuffers(1, &rockEBO);
+    glBindBuffer(GL_ARRAY_BUFFER, rockVBO);
+    glBufferData(GL_ARRAY_BUFFER, rockVertices.size() * sizeof(float), rockVertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rockEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, rockIndices.size() * sizeof(unsigned int), rockIndices.data(), GL_STATIC_DRAW);
+    int rockIndexCount = rockLods[0].indexCount;   // 不经过GPU剔除时只绘制最高细节
+
+    // 计算着色器路径使用的小行星VAO（实例数据来自SSBO，不需要实例属性）
+    unsigned int rockVAO;
+    glGenVertexArrays(1, &rockVAO);
+    glBindVertexArray(rockVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, rockVBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rockEBO);
+    glBindVertexArray(0);
+
     // 加载纹理
     unsigned int earthTexture = loadTexture("textures/earth.bmp");
     unsigned int moonTexture = loadTexture("textures/moon.bmp");
     unsigned int sunTexture = loadTexture("textures/sun.bmp");
 
+    // 轨道模拟（高倍率时间加速时在线程池上并行细分子步）
+    WorkerPool workerPool;
+    Simulation simulation(workerPool);
+
+    BodyDesc sunDesc = { "Sun", -1, 0.0f, 0.0f, 0.0f, 0.0f, 10.0f };
+    int sunIndex = simulation.addBody(sunDesc);
+    // 地球轨道在XZ平面，公转速度0.5，自转速度2.0
+    BodyDesc earthDesc = { "Earth", sunIndex, 50.0f, 0.5f, 0.0f, 2.0f, 3.0f };
+    int earthIndex = simulation.addBody(earthDesc);
+    // 月球绕地球公转（更快），轨道倾斜约15度
+    BodyDesc moonDesc = { "Moon", earthIndex, 8.0f, 2.0f, glm::radians(15.0f), 0.0f, 1.0f };
+    int moonIndex = simulation.addBody(moonDesc);
+
+    // 场景层级：每个天体一个轨道锚点（只含平移，子天体挂在其下）和一个网格节点（自转+缩放）
+    struct RenderBody
+    {
+        int body;
+        int parent;             // 父天体在 renderBodies 中的下标（总在本天体之前），-1 表示没有
+        int anchorNode;
+        int meshNode;
+        unsigned int texture;
+        glm::vec3 color;
+        bool isSun;
+        unsigned int features;  // 按天体类型选择的着色器变体
+        unsigned int program;   // 本帧使用的程序，变体还在编译时为 0
+    };
+    SceneGraph sceneGraph;
+    std::vector<RenderBody> renderBodies;
+    {
+        const unsigned int textures[] = { sunTexture, earthTexture, moonTexture };
+        const glm::vec3 colors[] = { glm::vec3(1.0f, 0.9f, 0.2f), glm::vec3(0.2f, 0.4f, 0.8f), glm::vec3(0.7f, 0.7f, 0.7f) };
+        const int bodies[] = { sunIndex, earthIndex, moonIndex };
+        // 模拟天体下标与渲染下标是两套编号，父天体通过这张表换算，不依赖两者顺序一致
+        std::vector<int> renderIndexOfBody(simulation.bodyCount(), -1);
+        for (int i = 0; i < 3; i++)
+        {
+            const BodyDesc& desc = simulation.desc(bodies[i]);
+            RenderBody rb;
+            rb.body = bodies[i];
+            rb.parent = desc.parent >= 0 ? renderIndexOfBody[desc.parent] : -1;
+            int parentAnchor = rb.parent >= 0 ? renderBodies[rb.parent].anchorNode : -1;
+            rb.anchorNode = sceneGraph.addNode(parentAnchor, glm::vec3(simulation.state(bodies[i]).relPos));
+            rb.meshNode = sceneGraph.addNode(rb.anchorNode, glm::vec3(0.0f), 0.0f,
+                                             glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(desc.radius));
+            rb.texture = textures[i];
+            rb.color = colors[i];
+            rb.isSun = bodies[i] == sunIndex;
+            rb.features = rb.isSun ? SUN_FEATURES : PLANET_FEATURES;
+            rb.program = 0;
+            renderIndexOfBody[bodies[i]] = (int)renderBodies.size();
+            renderBodies.push_back(rb);
+        }
+    }
+
+    // 录制与回放：回放时不再计算模拟，直接从内存映射的录制文件中解码天体状态
+    SimulationRecorder recorder;
+    SimulationReplay replay;
+    bool replaying = false;
+    if (replayPath)
+    {
+        replaying = replay.open(replayPath) && replay.bodyCount() == simulation.bodyCount();
+        if (!replaying)
+            std::cout << "Replay file cannot be used, running live simulation: " << replayPath << std::endl;
+    }
+    if (recordPath && !replaying)
+        recorder.open(recordPath, (unsigned int)simulation.bodyCount());
+
+    // 小行星带：位于地球轨道之外，角速度由太阳引力参数（按地球轨道推算）决定
+    AsteroidBelt asteroidBelt;
+    {
+        double sunGM = (double)earthDesc.orbitSpeed * earthDesc.orbitSpeed
+                     * earthDesc.orbitRadius * earthDesc.orbitRadius * earthDesc.orbitRadius;
+        asteroidBelt.generate(asteroidCount, 65.0f, 85.0f, sunGM, 2024u);
+        asteroidBelt.upload(rockVBO, rockEBO);
+    }
+
+    // 支持计算着色器时，小行星在GPU上按引力积分（太阳和行星为吸引体），状态常驻SSBO
+    GpuNBody gpuBelt;
+    bool useComputeBelt = false;
+    std::vector<NBodyAttractor> attractors;
+    std::vector<float> bodyGM(simulation.bodyCount(), 0.0f);
+    const int MAX_COMPUTE_SUBSTEPS = 32;
+    double lastComputeTime = simulation.time();
+    // 计算路径的初始化需要计算着色器程序，只在这里等待这两个
+    unsigned int nbodyComputeProgram = programBuilder.wait(nbodyComputeBuild);
+    unsigned int cullComputeProgram = programBuilder.wait(cullComputeBuild);
+    if (nbodyComputeProgram && allowCompute)
+    {
+        std::vector<NBodyParticle> particles;
+        particlesFromBelt(asteroidBelt, mutualGravity ? 1e-4f : 0.0f, particles);
+        useComputeBelt = gpuBelt.init(nbodyComputeProgram, particles);
+        // 父天体的引力参数由子天体的圆轨道推算
+        for (size_t i = 0; i < simulation.bodyCount(); i++)
+        {
+            if (simulation.desc((int)i).parent >= 0)
+                bodyGM[simulation.desc((int)i).parent] = (float)simulation.state((int)i).gm;
+        }
+    }
+
+    // GPU剔除：计算着色器逐颗做视锥/层级Z剔除和LOD选择，一次间接绘制提交整个小行星带
+    GpuInstanceCuller beltCuller;
+    bool useGpuCulling = useComputeBelt
+                         && beltCuller.init(cullComputeProgram, rockVBO, rockEBO, rockLods, gpuBelt.particleCount());
+    beltCuller.setSpritePixels(spritePixels);
+    std::cout << "Asteroid belt: " << asteroidCount << " rocks, "
+              << (useComputeBelt ? "compute shader N-body" : "vertex shader kinematic") << " path"
+              << (useGpuCulling ? ", GPU culling + multi-draw indirect" : "") << std::endl;
+
+    // 静态轨道线：轨道根数一次性上传，中心取父天体位置（orbitCenters 下标即渲染下标）
+    const int ORBIT_SEGMENTS = 128;
+    OrbitPaths orbitPaths;
+    for (const RenderBody& rb : renderBodies)
+    {
+        const BodyDesc& desc = simulation.desc(rb.body);
+        if (rb.parent < 0)
+            continue;
+        OrbitElements elements = { desc.orbitRadius, 0.0f, desc.orbitTilt, 0.0f, 0.0f };
+        orbitPaths.addOrbit(elements, rb.parent);
+    }
+    orbitPaths.upload();
+    std::vector<glm::vec3> orbitCenters(renderBodies.size());
+
+    // 轨迹线：除太阳外每个天体一条，固定频率采样，保留最近 8 秒
+    const int TRAIL_SAMPLES = 480;
+    const float TRAIL_SAMPLE_INTERVAL = 1.0f / 60.0f;
+    OrbitTrails orbitTrails;
+    orbitTrails.init((int)renderBodies.size() - 1, TRAIL_SAMPLES);
+    double lastTrailSample = 0.0;
+    double trailClock = 0.0;        // 暂停时不前进，轨迹停在原处而不是逐渐淡出
+    // 采样时间以 float 存入顶点缓冲，相对这个起点保存；运行很久后重新取起点，避免 float 精度不足
+    const double TRAIL_EPOCH_LENGTH = 3600.0;
+    double trailEpoch = 0.0;
+
+    std::vector<RecordedBody> frameBodies(simulation.bodyCount());
+    double replayClock = replay.startTime();    // 回放播放到的模拟时间
+    double replayTickTime = replayClock;        // 最近一次解码帧的模拟时间
+    if (replaying)
+        replay.nextTick(&replayTickTime, frameBodies.data());
+
+    // 视锥剔除：天体包围球按 SoA 存放，每帧批量测试后得到紧凑的可见列表
+    BoundingSpheres bodyBounds;
+    bodyBounds.resize(renderBodies.size());
+    for (size_t i = 0; i < renderBodies.size(); i++)
+        bodyBounds.set(i, glm::vec3(0.0f), simulation.desc(renderBodies[i].body).radius);
+
+    // 天体的双精度世界坐标，每帧批量转换为相对相机的坐标写入 bodyBounds，剔除与绘制都在相机空间中进行
+    WorldPositions bodyWorld;
+    bodyWorld.resize(renderBodies.size());
+    size_t sunRenderIndex = 0;
+    for (size_t i = 0; i < renderBodies.size(); i++)
+    {
+        if (renderBodies[i].isSun)
+            sunRenderIndex = i;
+    }
+    std::vector<uint32_t> visibleBodies;
+    CullStats cullStats = { 0, 0, 0 };
+
+    // 遮挡剔除：在后台线程上把上一帧的天体作为遮挡球光栅化，与模拟推进并行。
+    // 遮挡球保存上一帧的双精度世界坐标，开始光栅化前按本帧相机转换为相对坐标，
+    // 这样相机移动不会使遮挡球错位；天体自身位置晚一帧，按上一帧位移量的两倍收缩半径以保持保守
+    OcclusionCuller occlusionCuller;
+    BackgroundWorker occlusionWorker;
+    WorldPositions occluderWorld;
+    occluderWorld.resize(renderBodies.size());
+    std::vector<glm::vec3> occluderCenters(renderBodies.size());
+    std::vector<float> occluderRadii(renderBodies.size(), 0.0f);
+    bool haveLastPositions = false;
+    size_t occludedCount = 0;
+
+    // 每帧临时数据（渲染队列、交给后台线程的任务参数）从帧分配器中分配，稳定运行时渲染循环没有堆分配
+    FrameArena frameArena;
+
+    // 交给遮挡线程的参数放在帧分配器中，任务闭包只捕获一个指针，构造 std::function 时不需要堆分配
+    struct OcclusionJob
+    {
+        OcclusionCuller* culler;
+        const glm::vec3* centers;
+        const float* radii;
+        size_t count;
+        glm::mat4 view;
+        glm::mat4 projection;
+    };
+
+    // 天体通过渲染队列排序提交，状态缓存跳过重复的程序/VAO/纹理/uniform设置
+    RenderQueue renderQueue;
+    RenderStateCache stateCache;
+    size_t lastStateChanges = 0;
+    size_t lastAvoidedChanges = 0;
+
+    double lastTitleUpdate = 0.0;
+
+    // 天体绘制方式：替身每个天体只有4个顶点，轮廓和深度逐像素精确
+    unsigned int bodyVAO = useImpostors ? impostorVAO : VAO;
+    std::vector<unsigned int> bodyPrograms;
+
+    HudOverlay hudOverlay;
+    hudOverlay.init();
+
+    // --verify-no-alloc：着色器就绪并预热若干帧后，统计之后若干帧中的堆分配
+    unsigned long long framesRendered = 0;
+#ifdef ENABLE_ALLOCATION_CHECK
+    const unsigned long long ALLOCATION_CHECK_WARMUP = 120;
+    const unsigned long long ALLOCATION_CHECK_FRAMES = 600;
+    unsigned long long allocationCheckStart = 0;
+#endif
+    int exitCode = 0;
+
     // 渲染循环
+    // 按需渲染：记录上一帧的相机，判断本帧是否有变化
+    idleMode.setEnabled(allowIdle);
+    glm::dvec3 lastCameraPos = cameraPos;
+    glm::vec3 lastCameraFront = cameraFront;
+    float lastSpeedMultiplier = speedMultiplier;
+
     while (!glfwWindowShouldClose(window))
     {
+        // 上一帧之后场景和相机都没有变化：不重绘，等待输入、窗口事件或回放的下一帧
+        if (!idleMode.needsFrame())
+        {
+            double timeout = -1.0;
+            if (replaying && !simulationPaused)
+                timeout = (replayTickTime - replayClock) / speedMultiplier;
+            bool pausedBeforeWait = simulationPaused;
+            double waited = idleMode.waitForEvents(window, timeout);
+            // 暂停期间的等待不计入下一帧的时间步，否则取消暂停时模拟会一次推进整段等待时间
+            if (pausedBeforeWait)
+                lastFrame += waited;
+            framePacer.discontinuity();
+            if (glfwWindowShouldClose(window))
+                break;
+        }
+        idleMode.beginFrame();
+
+#ifdef ENABLE_PROFILER
+        profiler.beginFrame();
+#endif
+        frameArena.beginFrame();
+
         // 计算帧时间
-        float currentFrame = glfwGetTime();
+        double currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
         // 输入处理
         processInput(window);
 
-        // 清除屏幕
-        glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // 绑定场景帧缓冲并清除
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        sceneTarget.begin(framebufferWidth, framebufferHeight, glm::vec4(0.05f, 0.05f, 0.1f, 1.0f));
 
-        // 使用着色器
-        glUseProgram(shaderProgram);
+        // 设置变换矩阵：所有绘制都在以相机为原点的空间中进行，cameraView 只含旋转。
+        // 以世界原点为基准的数据（小行星、轨迹线）加上 worldOrigin，减去相机位置在双精度中完成
+        glm::mat4 projection = sceneTarget.projection(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, NEAR_PLANE);
+        glm::mat4 cameraView = glm::lookAt(glm::vec3(0.0f), cameraFront, cameraUp);
+        glm::vec3 worldOrigin = glm::vec3(-cameraPos);
 
-        // 设置变换矩阵
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 1000.0f);
-        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        // 取本帧已就绪的着色器程序
+        programBuilder.poll();
+        if (!shadersReady && programBuilder.pendingCount() == 0)
+        {
+            shadersReady = true;
+            std::cout << "Shaders ready after " << (int)((glfwGetTime() - shaderBuildStart) * 1000.0) << " ms"
+                      << (programBuilder.parallel() ? " (parallel compile)" : "") << std::endl;
+        }
+        bodyPrograms.clear();
+        for (RenderBody& rb : renderBodies)
+        {
+            rb.program = bodyVariants.get(rb.features);
+            if (rb.program && std::find(bodyPrograms.begin(), bodyPrograms.end(), rb.program) == bodyPrograms.end())
+                bodyPrograms.push_back(rb.program);
+        }
+        unsigned int orbitProgram = programBuilder.program(orbitBuild);
+        unsigned int trailProgram = programBuilder.program(trailBuild);
+        unsigned int spriteProgram = programBuilder.program(spriteBuild);
+
+        // 用本帧相机开始光栅化遮挡球
+        for (size_t i = 0; i < occluderCenters.size(); i++)
+            occluderCenters[i] = glm::vec3(occluderWorld.get(i) - cameraPos);
+        OcclusionJob* occlusionJob = frameArena.create<OcclusionJob>();
+        occlusionJob->culler = &occlusionCuller;
+        occlusionJob->centers = occluderCenters.data();
+        occlusionJob->radii = occluderRadii.data();
+        occlusionJob->count = occluderCenters.size();
+        occlusionJob->view = cameraView;
+        occlusionJob->projection = projection;
+        occlusionWorker.start([occlusionJob]()
+        {
+            PROFILE_CPU("occlusion raster");
+            occlusionJob->culler->begin(occlusionJob->view, occlusionJob->projection, NEAR_PLANE);
+            for (size_t i = 0; i < occlusionJob->count; i++)
+                occlusionJob->culler->addOccluder(occlusionJob->centers[i], occlusionJob->radii[i]);
+            occlusionJob->culler->buildHiZ();
+        });
+
+        if (replaying && !simulationPaused)
+        {
+            PROFILE_CPU("replay decode");
+            // 按加速倍率推进回放时钟，解码到该时刻为止的所有帧；落后太多时直接跳转
+            replayClock += deltaTime * speedMultiplier;
+            int decoded = 0;
+            while (replayTickTime < replayClock)
+            {
+                if (decoded == 4096)
+                {
+                    replay.seekTime(replayClock);
+                    decoded = 0;
+                }
+                if (!replay.nextTick(&replayTickTime, frameBodies.data()))
+                {
+                    // 播放结束，从头循环
+                    replay.seekTick(0);
+                    for (int i = 0; i < orbitTrails.trailCount(); i++)
+                        orbitTrails.reset(i);
+                    replayClock = replayTickTime = replay.startTime();
+                    break;
+                }
+                decoded++;
+            }
+        }
+        else if (!replaying && !simulationPaused)
+        {
+            // 推进模拟
+            simulation.advance(deltaTime, speedMultiplier);
+            for (size_t i = 0; i < frameBodies.size(); i++)
+            {
+                frameBodies[i].relPos = simulation.state((int)i).relPos;
+                frameBodies[i].spinAngle = simulation.state((int)i).spinAngle;
+            }
+            if (recorder.isOpen())
+                recorder.writeTick(simulation.time(), frameBodies.data());
+        }
 
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 1, glm::value_ptr(cameraPos));
+        // 同步天体状态到场景层级，只有发生变化的节点会重新计算世界矩阵
+        for (const RenderBody& rb : renderBodies)
+        {
+            const RecordedBody& state = frameBodies[rb.body];
+            sceneGraph.setTranslation(rb.anchorNode, glm::vec3(state.relPos));
+            sceneGraph.setRotation(rb.meshNode, (float)state.spinAngle, glm::vec3(0.0f, 1.0f, 0.0f)); // 自转
+        }
+        sceneGraph.update();
 
-        // 设置双光源
-        glUniform3f(glGetUniformLocation(shaderProgram, "sunLightPos"), 0.0f, 0.0f, 0.0f); // 太阳主光源
-        glUniform3f(glGetUniformLocation(shaderProgram, "backLightPos"), -30.0f, 20.0f, -30.0f); // 背光源
+        // 双精度世界坐标由父天体在前的顺序一次线性累加，再批量转换为相对相机的 float 坐标。
+        // 实时模拟和回放都从 frameBodies 的相对位置累加，父天体按渲染下标查找
+        for (size_t i = 0; i < renderBodies.size(); i++)
+        {
+            const RenderBody& rb = renderBodies[i];
+            glm::dvec3 position = frameBodies[rb.body].relPos;
+            if (rb.parent >= 0)
+                position += bodyWorld.get(rb.parent);
+            bodyWorld.set(i, position);
+        }
+        bodyWorld.toCameraRelative(cameraPos, bodyBounds.x.data(), bodyBounds.y.data(), bodyBounds.z.data());
 
-        glBindVertexArray(VAO);
+        // 视锥剔除，只绘制包围球与视锥相交的天体
+        cullSpheres(extractFrustum(projection * cameraView, sceneTarget.reversedZ()), bodyBounds, visibleBodies, &cullStats);
 
-        // 时间因子（用于动画）
-        float time = currentFrame * speedMultiplier;
+        // 再剔除被其他天体完全挡住的天体
+        occlusionWorker.wait();
+        occludedCount = occlusionCuller.filter(bodyBounds, visibleBodies);
 
-        // 1. 绘制太阳（中心）
+        // 为下一帧准备遮挡球
+        for (size_t i = 0; i < renderBodies.size(); i++)
         {
-            glBindTexture(GL_TEXTURE_2D, sunTexture);
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::scale(model, glm::vec3(10.0f)); // 太阳半径
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 1.0f, 0.9f, 0.2f);
-            glUniform1i(glGetUniformLocation(shaderProgram, "isSun"), 1);
-            glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 1);
-            glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+            glm::dvec3 position = bodyWorld.get(i);
+            float motion = haveLastPositions ? (float)glm::length(position - occluderWorld.get(i)) : 0.0f;
+            occluderWorld.set(i, position);
+            occluderRadii[i] = bodyBounds.radius[i] - 2.0f * motion;
         }
+        haveLastPositions = true;
 
-        // 2. 绘制地球
-        float earthOrbitRadius = 50.0f;
-        float earthSpeed = 0.5f; // 公转速度
-        float earthRotationSpeed = 2.0f; // 自转速度
-        float earthAngle = time * earthSpeed;
+        // 天体用到的每个着色器变体都设置一次相机和光源（相机空间：相机在原点，光源位置相对相机）
+        glm::vec3 sunLightPosition(bodyBounds.x[sunRenderIndex], bodyBounds.y[sunRenderIndex], bodyBounds.z[sunRenderIndex]);
+        glm::vec3 backLightPosition = glm::vec3(glm::dvec3(-30.0, 20.0, -30.0) - cameraPos);
+        for (unsigned int program : bodyPrograms)
+        {
+            glUseProgram(program);
+            glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(cameraView));
+            glUniform3f(glGetUniformLocation(program, "viewPos"), 0.0f, 0.0f, 0.0f);
+
+            // 设置双光源（自发光变体中没有这两个uniform，位置为 -1 时调用被忽略）
+            glUniform3fv(glGetUniformLocation(program, "sunLightPos"), 1, glm::value_ptr(sunLightPosition)); // 太阳主光源
+            glUniform3fv(glGetUniformLocation(program, "backLightPos"), 1, glm::value_ptr(backLightPosition)); // 背光源
+        }
 
-        // 地球轨道在XZ平面
-        float earthX = earthOrbitRadius * cos(earthAngle);
-        float earthZ = earthOrbitRadius * sin(earthAngle);
-        glm::vec3 earthPos = glm::vec3(earthX, 0.0f, earthZ);
+        // 可见天体放入渲染队列，按程序、纹理、由近到远排序后提交
+        renderQueue.begin(frameArena, visibleBodies.size());
+        for (uint32_t visibleIndex : visibleBodies)
+        {
+            const RenderBody& rb = renderBodies[visibleIndex];
+            if (!rb.program)
+                continue;
+            RenderCommand cmd;
+            cmd.program = rb.program;
+            cmd.vao = bodyVAO;
+            cmd.texture = rb.texture;
+            cmd.mode = useImpostors ? GL_TRIANGLE_STRIP : GL_TRIANGLES;
+            cmd.count = useImpostors ? 4 : indexCount;
+            cmd.indexed = !useImpostors;
+            // 自转与缩放取自场景层级，平移换成相对相机的坐标
+            cmd.model = sceneGraph.world(rb.meshNode);
+            cmd.model[3] = glm::vec4(bodyBounds.x[visibleIndex], bodyBounds.y[visibleIndex], bodyBounds.z[visibleIndex], 1.0f);
+            cmd.color = rb.color;
+            float distance = glm::length(glm::vec3(cmd.model[3]));
+            float depth = distance / (distance + SORT_DISTANCE_SCALE);
+            renderQueue.add(cmd, depth);
+        }
+        {
+            PROFILE_PASS("bodies");
+            stateCache.resetCounters();
+            renderQueue.submit(stateCache);
+            lastStateChanges = stateCache.changes();
+            lastAvoidedChanges = stateCache.avoided();
+        }
 
+        // 小行星带：计算着色器积分后直接从SSBO实例化绘制（回放时没有对应状态，使用运动学路径）
+        if (useComputeBelt && !replaying)
         {
-            glBindTexture(GL_TEXTURE_2D, earthTexture);
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, earthPos);
-            model = glm::rotate(model, time * earthRotationSpeed, glm::vec3(0.0f, 1.0f, 0.0f)); // 自转
-            model = glm::scale(model, glm::vec3(3.0f)); // 地球半径
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 0.2f, 0.4f, 0.8f);
-            glUniform1i(glGetUniformLocation(shaderProgram, "isSun"), 0);
-            glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 1);
-            glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+            PROFILE_PASS("asteroids");
+            double simDt = simulation.time() - lastComputeTime;
+            lastComputeTime = simulation.time();
+            if (simDt > 0.0)
+            {
+                // 积分在世界空间中进行，引力源取双精度世界坐标
+                attractors.clear();
+                for (size_t i = 0; i < renderBodies.size(); i++)
+                {
+                    float gm = bodyGM[renderBodies[i].body];
+                    if (gm > 0.0f)
+                    {
+                        NBodyAttractor at = { glm::vec3(bodyWorld.get(i)), gm };
+                        attractors.push_back(at);
+                    }
+                }
+                // 步长约为最内侧小行星周期的 1/180；超出每帧子步上限时小行星带相对慢放
+                const double maxStep = 0.1;
+                int substeps = std::min(MAX_COMPUTE_SUBSTEPS, (int)std::ceil(simDt / maxStep));
+                NBodyParams params = { (float)std::min(simDt / substeps, maxStep), substeps, mutualGravity, 0.05f };
+                gpuBelt.step(attractors, params);
+            }
+
+            gpuBelt.bindForDraw();
+            if (useGpuCulling)
+            {
+                // 复用本帧CPU构建的层级Z（天体作为遮挡物）
+                beltCuller.uploadHiZ(occlusionCuller);
+                beltCuller.cull(cameraView, worldOrigin, projection, NEAR_PLANE, sceneTarget.reversedZ(), gpuBelt.particleCount(), 1.0f, (float)sceneTarget.renderHeight());
+            }
+
+            unsigned int rockProgram = useGpuCulling ? nbodyIndirectShaders.get(ROCK_FEATURES) : nbodyShaders.get(ROCK_FEATURES);
+            if (rockProgram)
+            {
+                glUseProgram(rockProgram);
+                glUniformMatrix4fv(glGetUniformLocation(rockProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+                glUniformMatrix4fv(glGetUniformLocation(rockProgram, "view"), 1, GL_FALSE, glm::value_ptr(cameraView));
+                glUniform3fv(glGetUniformLocation(rockProgram, "originOffset"), 1, glm::value_ptr(worldOrigin));
+                glUniform3f(glGetUniformLocation(rockProgram, "viewPos"), 0.0f, 0.0f, 0.0f);
+                glUniform3fv(glGetUniformLocation(rockProgram, "sunLightPos"), 1, glm::value_ptr(sunLightPosition));
+                glUniform3fv(glGetUniformLocation(rockProgram, "backLightPos"), 1, glm::value_ptr(backLightPosition));
+                glUniform3f(glGetUniformLocation(rockProgram, "objectColor"), 0.55f, 0.5f, 0.45f);
+                if (useGpuCulling)
+                {
+                    beltCuller.draw();
+
+                    // 投影只有几个像素的小行星作为点精灵一次绘制
+                    if (spriteProgram)
+                    {
+                        glUseProgram(spriteProgram);
+                        glUniformMatrix4fv(glGetUniformLocation(spriteProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+                        glUniformMatrix4fv(glGetUniformLocation(spriteProgram, "view"), 1, GL_FALSE, glm::value_ptr(cameraView));
+                        glUniform3fv(glGetUniformLocation(spriteProgram, "originOffset"), 1, glm::value_ptr(worldOrigin));
+                        glUniform3f(glGetUniformLocation(spriteProgram, "viewPos"), 0.0f, 0.0f, 0.0f);
+                        glUniform3fv(glGetUniformLocation(spriteProgram, "sunLightPos"), 1, glm::value_ptr(sunLightPosition));
+                        glUniform3f(glGetUniformLocation(spriteProgram, "objectColor"), 0.55f, 0.5f, 0.45f);
+                        glUniform1f(glGetUniformLocation(spriteProgram, "meshRadius"), 1.0f);
+                        glUniform1f(glGetUniformLocation(spriteProgram, "viewportHeight"), (float)sceneTarget.renderHeight());
+                        beltCuller.drawSprites();
+                    }
+                }
+                else
+                {
+                    glBindVertexArray(rockVAO);
+                    glDrawElementsInstanced(GL_TRIANGLES, rockIndexCount, GL_UNSIGNED_INT, 0, gpuBelt.particleCount());
+                    glBindVertexArray(0);
+                }
+            }
+        }
+        // 小行星带：位置全部由顶点着色器根据 time 计算
+        else
+        {
+            PROFILE_PASS("asteroids");
+            double sceneTime = replaying ? replayTickTime : simulation.time();
+            glm::vec2 beltPhase = asteroidBelt.shaderPhase(sceneTime);
+            unsigned int beltProgram = beltShaders.get(ROCK_FEATURES);
+            if (beltProgram)
+            {
+                glUseProgram(beltProgram);
+                glUniformMatrix4fv(glGetUniformLocation(beltProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+                glUniformMatrix4fv(glGetUniformLocation(beltProgram, "view"), 1, GL_FALSE, glm::value_ptr(cameraView));
+                glUniform3fv(glGetUniformLocation(beltProgram, "originOffset"), 1, glm::value_ptr(worldOrigin));
+                glUniform3f(glGetUniformLocation(beltProgram, "viewPos"), 0.0f, 0.0f, 0.0f);
+                glUniform3fv(glGetUniformLocation(beltProgram, "sunLightPos"), 1, glm::value_ptr(sunLightPosition));
+                glUniform3fv(glGetUniformLocation(beltProgram, "backLightPos"), 1, glm::value_ptr(backLightPosition));
+                glUniform2fv(glGetUniformLocation(beltProgram, "orbitPhase"), 1, glm::value_ptr(beltPhase));
+                glUniform3f(glGetUniformLocation(beltProgram, "objectColor"), 0.55f, 0.5f, 0.45f);
+                asteroidBelt.draw(rockIndexCount);
+            }
+        }
+
+        // 轨道线：顶点由着色器根据轨道根数生成，每帧只更新少量轨道中心（相对相机的天体位置）
+        for (size_t i = 0; i < renderBodies.size(); i++)
+            orbitCenters[i] = glm::vec3(bodyBounds.x[i], bodyBounds.y[i], bodyBounds.z[i]);
+        if (orbitProgram)
+        {
+            PROFILE_PASS("orbits");
+            glUseProgram(orbitProgram);
+            glUniformMatrix4fv(glGetUniformLocation(orbitProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(orbitProgram, "view"), 1, GL_FALSE, glm::value_ptr(cameraView));
+            glUniform1i(glGetUniformLocation(orbitProgram, "segments"), ORBIT_SEGMENTS);
+            glUniform3fv(glGetUniformLocation(orbitProgram, "orbitCenters"),
+                         (GLsizei)std::min(orbitCenters.size(), (size_t)OrbitPaths::MAX_CENTERS), glm::value_ptr(orbitCenters[0]));
+            glUniform3f(glGetUniformLocation(orbitProgram, "orbitColor"), 0.6f, 0.6f, 0.7f);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            orbitPaths.draw(ORBIT_SEGMENTS);
+            glDisable(GL_BLEND);
+        }
+
+        // 轨迹线：每条轨迹只追加一个顶点，所有轨迹一次多重绘制
+        if (!simulationPaused)
+            trailClock += deltaTime;
+        if (trailClock - trailEpoch > TRAIL_EPOCH_LENGTH)
+        {
+            trailEpoch = trailClock;
+            for (int i = 0; i < orbitTrails.trailCount(); i++)
+                orbitTrails.reset(i);
+        }
+        if (trailClock - lastTrailSample >= TRAIL_SAMPLE_INTERVAL)
+        {
+            lastTrailSample = trailClock;
+            int trail = 0;
+            for (size_t i = 0; i < renderBodies.size(); i++)
+            {
+                if (!renderBodies[i].isSun)
+                    orbitTrails.append(trail++, glm::vec3(bodyWorld.get(i)), (float)(trailClock - trailEpoch));
+            }
+        }
+        if (trailProgram)
+        {
+            PROFILE_PASS("trails");
+            glUseProgram(trailProgram);
+            glUniformMatrix4fv(glGetUniformLocation(trailProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(trailProgram, "view"), 1, GL_FALSE, glm::value_ptr(cameraView));
+            glUniform3fv(glGetUniformLocation(trailProgram, "originOffset"), 1, glm::value_ptr(worldOrigin));
+            glUniform1f(glGetUniformLocation(trailProgram, "currentTime"), (float)(trailClock - trailEpoch));
+            glUniform1f(glGetUniformLocation(trailProgram, "trailDuration"), TRAIL_SAMPLES * TRAIL_SAMPLE_INTERVAL);
+            glUniform3f(glGetUniformLocation(trailProgram, "trailColor"), 0.5f, 0.7f, 1.0f);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glDepthMask(GL_FALSE);
+            orbitTrails.draw();
+            glDepthMask(GL_TRUE);
+            glDisable(GL_BLEND);
         }
 
-        // 3. 绘制月球
-        float moonOrbitRadius = 8.0f; // 相对地球的距离
-        float moonSpeed = 2.0f; // 绕地球公转速度（更快）
-        float moonAngle = time * moonSpeed;
+        // 场景画完，复制到窗口
+        {
+            PROFILE_PASS("resolve");
+            sceneTarget.resolve();
+        }
 
-        // 月球轨道倾斜（不在XZ平面，而是倾斜约15度）
-        float moonTilt = glm::radians(15.0f);
-        float moonX = moonOrbitRadius * cos(moonAngle);
-        float moonY = moonOrbitRadius * sin(moonAngle) * sin(moonTilt); // Y轴分量
-        float moonZ = moonOrbitRadius * sin(moonAngle) * cos(moonTilt); // Z轴分量
-        glm::vec3 moonPos = earthPos + glm::vec3(moonX, moonY, moonZ);
+        // 在标题栏显示实际加速倍率（超出每帧预算时会低于期望倍率）
+        if (currentFrame - lastTitleUpdate > 0.5)
+        {
+            lastTitleUpdate = currentFrame;
+            char title[288];
+            if (replaying)
+                snprintf(title, sizeof(title), "Sun-Earth-Moon System - replay tick %llu/%llu (x%.3g) - visible %zu, culled %zu, occluded %zu - state changes %zu (avoided %zu)",
+                         replay.currentTick(), replay.tickCount(), (double)speedMultiplier,
+                         visibleBodies.size(), cullStats.culled, occludedCount, lastStateChanges, lastAvoidedChanges);
+            else
+                snprintf(title, sizeof(title), "Sun-Earth-Moon System - warp x%.3g (target x%.3g, %lld substeps) - visible %zu, culled %zu, occluded %zu - state changes %zu (avoided %zu)",
+                         simulation.effectiveWarp(), (double)speedMultiplier, simulation.substeps(),
+                         visibleBodies.size(), cullStats.culled, occludedCount, lastStateChanges, lastAvoidedChanges);
+            glfwSetWindowTitle(window, title);
+        }
 
+        // 性能叠加层最后绘制，不做深度测试
+        if (showHud)
         {
-            glBindTexture(GL_TEXTURE_2D, moonTexture);
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, moonPos);
-            model = glm::scale(model, glm::vec3(1.0f)); // 月球半径
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 0.7f, 0.7f, 0.7f);
-            glUniform1i(glGetUniformLocation(shaderProgram, "isSun"), 0);
-            glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 1);
-            glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+            PROFILE_PASS("hud");
+            float hudY = 10.0f;
+#ifdef ENABLE_PROFILER
+            hudY = profiler.drawHud(hudOverlay, 10.0f, hudY);
+#endif
+            hudY = renderStats.drawHud(hudOverlay, 10.0f, hudY);
+            hudY = framePacer.drawHud(hudOverlay, 10.0f, hudY);
+            if (sceneTarget.dynamicResolution())
+                hudY = sceneTarget.drawHud(hudOverlay, 10.0f, hudY);
+            if (idleMode.enabled())
+                idleMode.drawHud(hudOverlay, 10.0f, hudY);
+            hudOverlay.draw(programBuilder.program(hudBuild), framebufferWidth, framebufferHeight);
         }
 
-        // 交换缓冲区和轮询事件
-        glfwSwapBuffers(window);
+        // 交换缓冲区和轮询事件，限制帧率时先等到本帧的呈现时刻
+        framePacer.waitForNextFrame();
+        {
+            PROFILE_CPU("swap");
+            glfwSwapBuffers(window);
+        }
+        framePacer.framePresented();
         glfwPollEvents();
+
+#ifdef ENABLE_PROFILER
+        profiler.endFrame();
+        float sceneGpuMs = 0.0f;
+        if (sceneTarget.dynamicResolution() && profiler.lastGpuMs(SCENE_PASSES, sizeof(SCENE_PASSES) / sizeof(SCENE_PASSES[0]), &sceneGpuMs))
+            sceneTarget.reportGpuTime(sceneGpuMs);
+#endif
+        renderStats.endFrame();
+        framesRendered++;
+
+        // 本帧有变化时下一帧还要重绘：模拟或回放在推进、场景层级有节点更新、相机移动、
+        // 着色器还在编译或正在录制性能跟踪
+        bool frameChanged = !shadersReady || (!simulationPaused && !replaying)
+                            || sceneGraph.lastUpdatedCount() > 0
+                            || cameraPos != lastCameraPos || cameraFront != lastCameraFront
+                            || speedMultiplier != lastSpeedMultiplier;
+#ifdef ENABLE_PROFILER
+        frameChanged = frameChanged || profiler.capturing();
+#endif
+        lastCameraPos = cameraPos;
+        lastCameraFront = cameraFront;
+        lastSpeedMultiplier = speedMultiplier;
+        idleMode.endFrame(frameChanged);
+
+        if (verifyNoAlloc)
+        {
+#ifdef ENABLE_ALLOCATION_CHECK
+            if (allocationCheckStart == 0 && shadersReady && framesRendered >= ALLOCATION_CHECK_WARMUP)
+            {
+                allocationCheckStart = framesRendered;
+                resetAllocationTracking();
+                setAllocationTracking(true);
+            }
+            else if (allocationCheckStart != 0 && framesRendered - allocationCheckStart >= ALLOCATION_CHECK_FRAMES)
+            {
+                setAllocationTracking(false);
+                if (trackedAllocations() == 0)
+                {
+                    std::cout << "Allocation check passed: no heap allocations in " << ALLOCATION_CHECK_FRAMES << " frames" << std::endl;
+                }
+                else
+                {
+                    std::cout << "ERROR::ALLOCATION_CHECK::HEAP_ALLOCATION_IN_FRAME_LOOP: " << trackedAllocations()
+                              << " allocations (" << trackedAllocationBytes() << " bytes, first " << firstTrackedAllocationSize()
+                              << " bytes) in " << ALLOCATION_CHECK_FRAMES << " frames" << std::endl;
+                    exitCode = 1;
+                }
+                glfwSetWindowShouldClose(window, true);
+            }
+#else
+            std::cout << "ERROR::ALLOCATION_CHECK::NOT_COMPILED: rebuild with -DENABLE_ALLOCATION_CHECK=ON" << std::endl;
+            exitCode = 1;
+            glfwSetWindowShouldClose(window, true);
+#endif
+        }
+    }
+
+    renderStats.closeLog();
+    framePacer.printSummary();
+    if (idleMode.enabled())
+        idleMode.printSummary();
+    if (recorder.isOpen())
+    {
+        recorder.close();
+        std::cout << "Recorded " << recorder.tickCount() << " ticks (" << recorder.bytesWritten() << " bytes)" << std::endl;
     }
 
     // 清理资源
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
-    glDeleteProgram(shaderProgram);
+    bodyShaders.release();
+    impostorShaders.release();
+    beltShaders.release();
+    nbodyShaders.release();
+    nbodyIndirectShaders.release();
+    glDeleteVertexArrays(1, &impostorVAO);
+    const int builds[] = { trailBuild, orbitBuild, nbodyComputeBuild, cullComputeBuild, spriteBuild, hudBuild };
+    for (int build : builds)
+    {
+        if (programBuilder.program(build))
+            glDeleteProgram(programBuilder.program(build));
+    }
+    programBuilder.release();
+    beltCuller.release();
+    gpuBelt.release();
+    glDeleteVertexArrays(1, &rockVAO);
+    asteroidBelt.release();
+    glDeleteBuffers(1, &rockVBO);
+    glDeleteBuffers(1, &rockEBO);
+    orbitPaths.release();
+    orbitTrails.release();
+    hudOverlay.release();
+    sceneTarget.release();
+#ifdef ENABLE_PROFILER
+    profiler.releaseGpu();
+#endif
 
     glfwTerminate();
-    return 0;
+    return exitCode;
 }
 
 // 创建球体网格
@@ -272,75 +1179,32 @@ void createSphere(std::vector<float>& vertices, std::vector<unsigned int>& indic
 std::string readShaderFile(const char* filePath)
 {
     std::string content;
-    std::ifstream file;
-    file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try
-    {
-        file.open(filePath);
-        std::stringstream stream;
-        stream << file.rdbuf();
-        file.close();
-        content = stream.str();
-    }
-    catch (std::ifstream::failure& e)
-    {
+    if (!readResource(filePath, content))
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << filePath << std::endl;
-    }
-
     return content;
 }
 
-// 创建着色器程序
-unsigned int createShaderProgram(const char* vertexPath, const char* fragmentPath)
+// 读取一对顶点/片段着色器
+std::vector<ShaderStage> loadShaderStages(const char* vertexPath, const char* fragmentPath)
 {
-    std::string vertexCode = readShaderFile(vertexPath);
-    std::string fragmentCode = readShaderFile(fragmentPath);
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    unsigned int vertex, fragment;
-    int success;
-    char infoLog[512];
-
-    // 顶点着色器
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // 片段着色器
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // 着色器程序
-    unsigned int program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
-    glLinkProgram(program);
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(program, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    std::vector<ShaderStage> stages(2);
+    stages[0].type = GL_VERTEX_SHADER;
+    stages[0].source = readShaderFile(vertexPath);
+    stages[0].path = vertexPath;
+    stages[1].type = GL_FRAGMENT_SHADER;
+    stages[1].source = readShaderFile(fragmentPath);
+    stages[1].path = fragmentPath;
+    return stages;
+}
 
-    return program;
+// 读取计算着色器
+std::vector<ShaderStage> loadComputeStage(const char* computePath)
+{
+    std::vector<ShaderStage> stages(1);
+    stages[0].type = GL_COMPUTE_SHADER;
+    stages[0].source = readShaderFile(computePath);
+    stages[0].path = computePath;
+    return stages;
 }
 
 // 处理输入
@@ -349,31 +1213,57 @@ void processInput(GLFWwindow *window)
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
-    float cameraSpeed = 50.0f * deltaTime;
+    // 空闲等待后的第一帧时间步可能很长，移动与调速按不超过 0.1 秒计算，避免相机跳跃
+    float inputStep = (float)std::min(deltaTime, 0.1);
+    float cameraSpeed = 50.0f * inputStep;
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        cameraPos += cameraSpeed * cameraFront;
+        cameraPos += glm::dvec3(cameraSpeed * cameraFront);
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        cameraPos -= cameraSpeed * cameraFront;
+        cameraPos -= glm::dvec3(cameraSpeed * cameraFront);
     if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+        cameraPos -= glm::dvec3(glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed);
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+        cameraPos += glm::dvec3(glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed);
     if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
-        cameraPos += cameraSpeed * cameraUp;
+        cameraPos += glm::dvec3(cameraSpeed * cameraUp);
     if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
-        cameraPos -= cameraSpeed * cameraUp;
+        cameraPos -= glm::dvec3(cameraSpeed * cameraUp);
 
-    // 速度控制
+    // 速度控制（按住时每秒翻倍/减半）
     if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
-        speedMultiplier += 0.1f * deltaTime;
+        speedMultiplier = std::min(MAX_SPEED_MULTIPLIER, speedMultiplier * std::pow(2.0f, inputStep));
     if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
-        speedMultiplier = std::max(0.1f, speedMultiplier - 0.1f * deltaTime);
+        speedMultiplier = std::max(MIN_SPEED_MULTIPLIER, speedMultiplier / std::pow(2.0f, inputStep));
+}
+
+// 按键回调：只处理按一次触发的功能键，持续按住的移动键在 processInput 中处理
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    idleMode.invalidate();
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_F1)
+        showHud = !showHud;
+    else if (key == GLFW_KEY_P)
+        simulationPaused = !simulationPaused;
+#ifdef ENABLE_PROFILER
+    // 记录接下来 120 帧，用 chrome://tracing 或 ui.perfetto.dev 打开
+    else if (key == GLFW_KEY_F2)
+        profiler.captureTrace("profile_trace.json", 120);
+#endif
 }
 
 // 窗口大小改变回调
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
     glViewport(0, 0, width, height);
+    idleMode.invalidate();
+}
+
+// 窗口需要重绘（被遮挡后重新露出等）：空闲时窗口内容可能已丢失
+void window_refresh_callback(GLFWwindow* window)
+{
+    idleMode.invalidate();
 }
 
 // 鼠标移动回调
@@ -386,6 +1276,7 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
         firstMouse = false;
     }
 
+    idleMode.invalidate();
     float xoffset = xpos - lastX;
     float yoffset = lastY - ypos;
     lastX = xpos;
@@ -413,11 +1304,13 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 // 鼠标滚轮回调
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 {
-    speedMultiplier += yoffset * 0.1f;
-    if (speedMultiplier < 0.1f)
-        speedMultiplier = 0.1f;
-    if (speedMultiplier > 10.0f)
-        speedMultiplier = 10.0f;
+    idleMode.invalidate();
+    // 按比例调整，滚动几十格即可从 0.1 倍到 1e7 倍
+    speedMultiplier *= std::pow(1.5f, (float)yoffset);
+    if (speedMultiplier < MIN_SPEED_MULTIPLIER)
+        speedMultiplier = MIN_SPEED_MULTIPLIER;
+    if (speedMultiplier > MAX_SPEED_MULTIPLIER)
+        speedMultiplier = MAX_SPEED_MULTIPLIER;
 }
 
 // 纹理加载函数
@@ -427,7 +1320,10 @@ unsigned int loadTexture(const char* path)
     glGenTextures(1, &textureID);
 
     int width, height, nrComponents;
-    unsigned char *data = loadBMP(path, &width, &height, &nrComponents);
+    std::string file;
+    unsigned char *data = NULL;
+    if (readResource(path, file))
+        data = loadBMPFromMemory((const unsigned char*)file.data(), file.size(), &width, &height, &nrComponents);
     if (data)
     {
         GLenum format;
@@ -0,0 +1,98 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 定长对象池：长期存在、数量不定的对象按块分配，每块 objectsPerBlock 个。
+//
+// 释放的槽位放入空闲链表，之后的 create 优先复用，对象地址在销毁前保持不变。
+// 块只在池析构时释放；池析构时仍存活的对象会被析构。不是线程安全的。
+template <typename T, size_t objectsPerBlock = 32>
+class ObjectPool
+{
+public:
+    ObjectPool() : freeList(NULL), nextSlot(objectsPerBlock), live(0) {}
+
+    ~ObjectPool()
+    {
+        // 空闲链表中的槽位不需要析构，其余都是存活对象
+        std::vector<bool> freeSlots(blocks.size() * objectsPerBlock, false);
+        for (Slot* slot = freeList; slot; slot = slot->next)
+            freeSlots[indexOf(slot)] = true;
+        for (size_t b = 0; b < blocks.size(); b++)
+        {
+            size_t used = b + 1 == blocks.size() ? nextSlot : objectsPerBlock;
+            for (size_t i = 0; i < used; i++)
+            {
+                if (!freeSlots[b * objectsPerBlock + i])
+                    reinterpret_cast<T*>(&blocks[b][i])->~T();
+            }
+            delete[] blocks[b];
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args)
+    {
+        Slot* slot = freeList;
+        if (slot)
+        {
+            freeList = slot->next;
+        }
+        else
+        {
+            if (nextSlot == objectsPerBlock)
+            {
+                blocks.push_back(new Slot[objectsPerBlock]);
+                nextSlot = 0;
+            }
+            slot = &blocks.back()[nextSlot++];
+        }
+        live++;
+        return new (slot) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object)
+    {
+        if (!object)
+            return;
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+        live--;
+    }
+
+    size_t size() const { return live; }
+    size_t capacity() const { return blocks.size() * objectsPerBlock; }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    size_t indexOf(const Slot* slot) const
+    {
+        for (size_t b = 0; b < blocks.size(); b++)
+        {
+            if (slot >= blocks[b] && slot < blocks[b] + objectsPerBlock)
+                return b * objectsPerBlock + (size_t)(slot - blocks[b]);
+        }
+        return 0;
+    }
+
+    std::vector<Slot*> blocks;
+    Slot* freeList;
+    size_t nextSlot;        // 最后一块中下一个从未用过的槽位
+    size_t live;
+};
+
+#endif // OBJECT_POOL_H
@@ -0,0 +1,185 @@
+#include "occlusion_culling.h"
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_SSE
+#endif
+
+namespace
+{
+    const float FAR_DEPTH = std::numeric_limits<float>::infinity();
+}
+
+OcclusionCuller::OcclusionCuller(int width, int height)
+    : viewMatrix(1.0f), focalX(1.0f), focalY(1.0f), nearDistance(0.1f)
+{
+    // 预先分配全部层级，之后每帧不再分配内存
+    int w = width, h = height;
+    for (;;)
+    {
+        levels.push_back(std::vector<float>((size_t)w * h, FAR_DEPTH));
+        levelWidths.push_back(w);
+        levelHeights.push_back(h);
+        if (w == 1 && h == 1)
+            break;
+        w = std::max(1, (w + 1) / 2);
+        h = std::max(1, (h + 1) / 2);
+    }
+}
+
+void OcclusionCuller::begin(const glm::mat4& view, const glm::mat4& projection, float nearPlane)
+{
+    viewMatrix = view;
+    focalX = projection[0][0];
+    focalY = projection[1][1];
+    nearDistance = nearPlane;
+    std::fill(levels[0].begin(), levels[0].end(), FAR_DEPTH);
+}
+
+void OcclusionCuller::addOccluder(const glm::vec3& center, float radius)
+{
+    if (radius <= 0.0f)
+        return;
+
+    glm::vec4 v = viewMatrix * glm::vec4(center, 1.0f);
+    float dist = -v.z;
+    if (dist - radius <= nearDistance)
+        return;
+
+    // 截面圆盘投影到像素坐标
+    int w = levelWidths[0], h = levelHeights[0];
+    float sx = (focalX * v.x / dist * 0.5f + 0.5f) * w;
+    float sy = (focalY * v.y / dist * 0.5f + 0.5f) * h;
+    float sr = radius / dist * 0.5f * std::min(focalX * w, focalY * h);
+    rasterizeDisc(sx, sy, sr, dist);
+}
+
+void OcclusionCuller::rasterizeDisc(float cx, float cy, float radius, float depth)
+{
+    int w = levelWidths[0], h = levelHeights[0];
+    float* buffer = levels[0].data();
+
+    // 保守光栅化：只写入整个像素都在圆盘内的像素。轮廓上部分覆盖的像素若写入，
+    // 层级Z取 2x2 最大值时会把错误的深度逐级传上去，把紧贴天体边缘后方的物体误剔除。
+    // 像素 [x, x+1] x [y, y+1] 完全在圆内当且仅当离圆心较远的那条水平边的两个端点都在圆内
+    int y0 = std::max(0, (int)std::ceil(cy - radius));
+    int y1 = std::min(h - 1, (int)std::floor(cy + radius) - 1);
+    for (int y = y0; y <= y1; y++)
+    {
+        float dy = std::max(std::fabs(y - cy), std::fabs(y + 1.0f - cy));
+        float half2 = radius * radius - dy * dy;
+        if (half2 <= 0.0f)
+            continue;
+        float half = std::sqrt(half2);
+        int x0 = std::max(0, (int)std::ceil(cx - half));
+        int x1 = std::min(w - 1, (int)std::floor(cx + half) - 1);
+        if (x0 > x1)
+            continue;
+
+        // 按扫描线区间批量取最小深度
+        float* row = buffer + (size_t)y * w;
+        int x = x0;
+#if defined(__AVX__)
+        __m256 d8 = _mm256_set1_ps(depth);
+        for (; x + 8 <= x1 + 1; x += 8)
+            _mm256_storeu_ps(row + x, _mm256_min_ps(_mm256_loadu_ps(row + x), d8));
+#elif defined(OCCLUSION_SSE)
+        __m128 d4 = _mm_set1_ps(depth);
+        for (; x + 4 <= x1 + 1; x += 4)
+            _mm_storeu_ps(row + x, _mm_min_ps(_mm_loadu_ps(row + x), d4));
+#endif
+        for (; x <= x1; x++)
+            row[x] = std::min(row[x], depth);
+    }
+}
+
+void OcclusionCuller::buildHiZ()
+{
+    PROFILE_CPU("hi-z build");
+    // 每级取 2x2 中的最大（最远）深度，保证测试保守
+    for (size_t l = 1; l < levels.size(); l++)
+    {
+        const std::vector<float>& src = levels[l - 1];
+        std::vector<float>& dst = levels[l];
+        int sw = levelWidths[l - 1], sh = levelHeights[l - 1];
+        int dw = levelWidths[l], dh = levelHeights[l];
+        for (int y = 0; y < dh; y++)
+        {
+            int ya = std::min(y * 2, sh - 1), yb = std::min(y * 2 + 1, sh - 1);
+            for (int x = 0; x < dw; x++)
+            {
+                int xa = std::min(x * 2, sw - 1), xb = std::min(x * 2 + 1, sw - 1);
+                float m = std::max(std::max(src[(size_t)ya * sw + xa], src[(size_t)ya * sw + xb]),
+                                   std::max(src[(size_t)yb * sw + xa], src[(size_t)yb * sw + xb]));
+                dst[(size_t)y * dw + x] = m;
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isOccluded(const glm::vec3& center, float radius) const
+{
+    glm::vec4 v = viewMatrix * glm::vec4(center, 1.0f);
+    float dist = -v.z;
+    float nearest = dist - radius;
+    if (nearest <= nearDistance)
+        return false;
+
+    // 用包围盒的四个角投影，得到保守的屏幕矩形
+    float farthest = dist + radius;
+    float minX = std::min((v.x - radius) / nearest, (v.x - radius) / farthest);
+    float maxX = std::max((v.x + radius) / nearest, (v.x + radius) / farthest);
+    float minY = std::min((v.y - radius) / nearest, (v.y - radius) / farthest);
+    float maxY = std::max((v.y + radius) / nearest, (v.y + radius) / farthest);
+
+    int w = levelWidths[0], h = levelHeights[0];
+    int x0 = (int)std::floor((focalX * minX * 0.5f + 0.5f) * w);
+    int x1 = (int)std::floor((focalX * maxX * 0.5f + 0.5f) * w);
+    int y0 = (int)std::floor((focalY * minY * 0.5f + 0.5f) * h);
+    int y1 = (int)std::floor((focalY * maxY * 0.5f + 0.5f) * h);
+
+    // 超出屏幕的部分无法判断，视为可见
+    if (x0 < 0 || y0 < 0 || x1 >= w || y1 >= h)
+        return false;
+
+    // 选择矩形最多覆盖 2x2 个纹素的层级
+    int level = 0;
+    while (level + 1 < (int)levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+        level++;
+
+    const std::vector<float>& hiz = levels[level];
+    int lw = levelWidths[level];
+    for (int y = y0 >> level; y <= (y1 >> level); y++)
+    {
+        for (int x = x0 >> level; x <= (x1 >> level); x++)
+        {
+            if (hiz[(size_t)y * lw + x] >= nearest)
+                return false;
+        }
+    }
+    return true;
+}
+
+size_t OcclusionCuller::filter(const BoundingSpheres& spheres, std::vector<uint32_t>& indices) const
+{
+    PROFILE_CPU("occlusion test");
+    size_t kept = 0;
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        uint32_t index = indices[i];
+        glm::vec3 c(spheres.x[index], spheres.y[index], spheres.z[index]);
+        if (!isOccluded(c, spheres.radius[index]))
+            indices[kept++] = index;
+    }
+    size_t removed = indices.size() - kept;
+    indices.resize(kept);
+    return removed;
+}
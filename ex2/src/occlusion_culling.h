@@ -0,0 +1,55 @@
+#ifndef OCCLUSION_CULLING_H
+#define OCCLUSION_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "frustum_culling.h"
+
+// 软件遮挡剔除：把少量大的遮挡球光栅化到低分辨率深度缓冲，
+// 再用其层级Z（每级取 2x2 中的最远深度）测试被遮挡物包围球的屏幕矩形。
+//
+// 遮挡球按过球心、垂直于视线的截面圆盘光栅化，深度取球心深度：
+// 圆盘内任意像素的视线在到达该深度之前必然先穿过球体，因此结果是保守的。
+// 深度缓冲存放视空间线性距离，没有遮挡的像素为无穷远。
+class OcclusionCuller
+{
+public:
+    OcclusionCuller(int width = 256, int height = 128);
+
+    // 开始新的一帧：清空深度缓冲并记录相机
+    void begin(const glm::mat4& view, const glm::mat4& projection, float nearPlane);
+    // 光栅化一个遮挡球（与近平面相交的球会被跳过）
+    void addOccluder(const glm::vec3& center, float radius);
+    // 构建层级Z，之后才能测试
+    void buildHiZ();
+
+    // 包围球是否被完全遮挡
+    bool isOccluded(const glm::vec3& center, float radius) const;
+
+    // 从 indices 中移除被遮挡的下标，返回移除的数量
+    size_t filter(const BoundingSpheres& spheres, std::vector<uint32_t>& indices) const;
+
+    int width() const { return levelWidths[0]; }
+    int height() const { return levelHeights[0]; }
+    const float* depth(int level = 0) const { return levels[level].data(); }
+    int levelCount() const { return (int)levels.size(); }
+    int levelWidth(int level) const { return levelWidths[level]; }
+    int levelHeight(int level) const { return levelHeights[level]; }
+
+private:
+    void rasterizeDisc(float cx, float cy, float radius, float depth);
+
+    std::vector<std::vector<float> > levels;
+    std::vector<int> levelWidths;
+    std::vector<int> levelHeights;
+
+    glm::mat4 viewMatrix;
+    float focalX;       // projection[0][0]
+    float focalY;       // projection[1][1]
+    float nearDistance;
+};
+
+#endif // OCCLUSION_CULLING_H
@@ -0,0 +1,84 @@
+#include "orbit_paths.h"
+
+#include <iostream>
+
+OrbitPaths::OrbitPaths()
+    : vao(0), vbo(0), uploadedCount(0)
+{
+}
+
+std::string OrbitPaths::shaderDefine()
+{
+    return "MAX_ORBIT_CENTERS " + std::to_string(MAX_CENTERS);
+}
+
+OrbitPaths::~OrbitPaths()
+{
+    release();
+}
+
+bool OrbitPaths::addOrbit(const OrbitElements& elements, int centerSlot)
+{
+    // 着色器按下标读取 orbitCenters，越界是未定义行为
+    if (centerSlot < 0 || centerSlot >= MAX_CENTERS)
+    {
+        std::cout << "ERROR::ORBIT_PATHS::CENTER_OUT_OF_RANGE: slot " << centerSlot
+                  << " (max " << MAX_CENTERS - 1 << ")" << std::endl;
+        return false;
+    }
+
+    Instance inst;
+    inst.semiMajorAxis = elements.semiMajorAxis;
+    inst.eccentricity = elements.eccentricity;
+    inst.inclination = elements.inclination;
+    inst.ascendingNode = elements.ascendingNode;
+    inst.periapsis = elements.periapsis;
+    inst.centerSlot = (float)centerSlot;
+    instances.push_back(inst);
+    return true;
+}
+
+void OrbitPaths::upload()
+{
+    if (!vao)
+    {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+    }
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), instances.data(), GL_STATIC_DRAW);
+
+    // 轨道根数 (a, e, i, Ω)
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribDivisor(0, 1);
+    // 近心点幅角、中心下标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    uploadedCount = (int)instances.size();
+}
+
+void OrbitPaths::release()
+{
+    if (vbo)
+        glDeleteBuffers(1, &vbo);
+    if (vao)
+        glDeleteVertexArrays(1, &vao);
+    vbo = vao = 0;
+    uploadedCount = 0;
+}
+
+void OrbitPaths::draw(int segments)
+{
+    if (uploadedCount == 0)
+        return;
+
+    glBindVertexArray(vao);
+    glDrawArraysInstanced(GL_LINE_LOOP, 0, segments, uploadedCount);
+    glBindVertexArray(0);
+}
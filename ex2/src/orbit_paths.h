@@ -0,0 +1,64 @@
+#ifndef ORBIT_PATHS_H
+#define ORBIT_PATHS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// 开普勒轨道根数（圆轨道取 eccentricity = 0）
+struct OrbitElements
+{
+    float semiMajorAxis;    // 半长轴（圆轨道即半径）
+    float eccentricity;     // 偏心率
+    float inclination;      // 轨道倾角（弧度，绕X轴倾斜，与月球 moonTilt 约定一致）
+    float ascendingNode;    // 升交点经度（弧度，绕Y轴）
+    float periapsis;        // 近心点幅角（弧度）
+};
+
+// 静态轨道线：不存任何顶点数据，顶点着色器用 gl_VertexID 和实例的轨道根数生成轨道上的点
+//
+// 轨道根数在初始化时一次性上传为实例属性，之后每帧没有任何缓冲上传；
+// 所有轨道一次 glDrawArraysInstanced 绘制。绕运动天体的轨道（如月球）通过
+// orbitCenters 统一变量数组取得中心位置。
+class OrbitPaths
+{
+public:
+    // 着色器中 orbitCenters 数组的长度，编译着色器时以 MAX_ORBIT_CENTERS 宏传入
+    static const int MAX_CENTERS = 64;
+    // 编译 orbit_vertex.glsl 时需要注入的宏（"MAX_ORBIT_CENTERS 64"）
+    static std::string shaderDefine();
+
+    OrbitPaths();
+    ~OrbitPaths();
+
+    // centerSlot 为轨道中心在 orbitCenters 中的下标，超出 [0, MAX_CENTERS) 时不添加并返回 false
+    bool addOrbit(const OrbitElements& elements, int centerSlot);
+    // 上传实例数据（轨道增删后调用一次）
+    void upload();
+    void release();
+
+    // 绘制所有轨道，每条轨道 segments 个点，调用前需设置好着色器
+    void draw(int segments);
+
+    int orbitCount() const { return (int)instances.size(); }
+
+private:
+    struct Instance
+    {
+        float semiMajorAxis;
+        float eccentricity;
+        float inclination;
+        float ascendingNode;
+        float periapsis;
+        float centerSlot;
+    };
+
+    unsigned int vao;
+    unsigned int vbo;
+    std::vector<Instance> instances;
+    int uploadedCount;
+};
+
+#endif // ORBIT_PATHS_H
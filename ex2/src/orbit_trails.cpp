@@ -0,0 +1,105 @@
+#include "orbit_trails.h"
+
+OrbitTrails::OrbitTrails()
+    : vao(0), vbo(0), samples(0), stride(0)
+{
+}
+
+OrbitTrails::~OrbitTrails()
+{
+    release();
+}
+
+void OrbitTrails::init(int trailCount, int samplesPerTrail)
+{
+    release();
+
+    samples = samplesPerTrail;
+    stride = samples + 1;
+    heads.assign(trailCount, 0);
+    counts.assign(trailCount, 0);
+    drawFirsts.assign(trailCount * 2, 0);
+    drawCounts.assign(trailCount * 2, 0);
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // 只分配显存，之后只做单顶点的局部更新
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)trailCount * stride * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+
+    // 位置 + 采样时间
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindVertexArray(0);
+}
+
+void OrbitTrails::release()
+{
+    if (vbo)
+        glDeleteBuffers(1, &vbo);
+    if (vao)
+        glDeleteVertexArrays(1, &vao);
+    vbo = vao = 0;
+    heads.clear();
+    counts.clear();
+}
+
+void OrbitTrails::append(int trail, const glm::vec3& position, float time)
+{
+    const float vertex[4] = { position.x, position.y, position.z, time };
+    int head = heads[trail];
+    GLintptr base = (GLintptr)trail * stride;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, (base + head) * sizeof(vertex), sizeof(vertex), vertex);
+    // 第 0 个采样同时写到末尾的额外槽位，环形缓冲绕回时线带不会断开
+    if (head == 0)
+        glBufferSubData(GL_ARRAY_BUFFER, (base + samples) * sizeof(vertex), sizeof(vertex), vertex);
+
+    heads[trail] = (head + 1) % samples;
+    if (counts[trail] < samples)
+        counts[trail]++;
+}
+
+void OrbitTrails::reset(int trail)
+{
+    heads[trail] = 0;
+    counts[trail] = 0;
+}
+
+void OrbitTrails::draw()
+{
+    int trails = (int)heads.size();
+    if (trails == 0)
+        return;
+
+    for (int i = 0; i < trails; i++)
+    {
+        GLint base = i * stride;
+        int head = heads[i];
+        if (counts[i] < samples)
+        {
+            // 还没写满，只有一段
+            drawFirsts[i * 2] = base;
+            drawCounts[i * 2] = counts[i];
+            drawFirsts[i * 2 + 1] = base;
+            drawCounts[i * 2 + 1] = 0;
+        }
+        else
+        {
+            // 最旧的采样在 head 处：先画 [head, samples]（含复制的第 0 个），再画 [0, head)
+            // head 为 0 时末尾的复制槽就是最旧的采样，不能再连回去
+            drawFirsts[i * 2] = base + head;
+            drawCounts[i * 2] = head == 0 ? samples : samples - head + 1;
+            drawFirsts[i * 2 + 1] = base;
+            drawCounts[i * 2 + 1] = head;
+        }
+    }
+
+    glBindVertexArray(vao);
+    glMultiDrawArrays(GL_LINE_STRIP, drawFirsts.data(), drawCounts.data(), trails * 2);
+    glBindVertexArray(0);
+}
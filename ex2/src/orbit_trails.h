@@ -0,0 +1,48 @@
+#ifndef ORBIT_TRAILS_H
+#define ORBIT_TRAILS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// 轨迹线：所有轨迹共用一个GPU顶点缓冲，每条轨迹占其中固定长度的一段环形缓冲
+//
+// 每帧每条轨迹只用 glBufferSubData 追加一个顶点（位置 + 采样时间），
+// 绘制时按环形头部拆成两段线带，全部轨迹用一次 glMultiDrawArrays 提交。
+class OrbitTrails
+{
+public:
+    OrbitTrails();
+    ~OrbitTrails();
+
+    // 分配 trailCount 条轨迹，每条保留 samplesPerTrail 个采样点
+    void init(int trailCount, int samplesPerTrail);
+    void release();
+
+    // 向第 trail 条轨迹追加一个采样点
+    void append(int trail, const glm::vec3& position, float time);
+    // 清空某条轨迹（例如回放跳转后）
+    void reset(int trail);
+
+    // 一次多重绘制所有轨迹，调用前需设置好着色器
+    void draw();
+
+    int trailCount() const { return (int)heads.size(); }
+    int samplesPerTrail() const { return samples; }
+
+private:
+    unsigned int vao;
+    unsigned int vbo;
+    int samples;
+    int stride;                 // 每条轨迹的顶点数（samples + 1，最后一个复制第 0 个以接上环形缓冲）
+
+    std::vector<int> heads;     // 下一次写入的位置
+    std::vector<int> counts;    // 已写入的采样数（不超过 samples）
+
+    // glMultiDrawArrays 参数，每条轨迹两段
+    std::vector<GLint> drawFirsts;
+    std::vector<GLsizei> drawCounts;
+};
+
+#endif // ORBIT_TRAILS_H
@@ -0,0 +1,382 @@
+#include "profiler.h"
+
+#include "hud_overlay.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    // 每个线程第一次记录时指向自己的缓冲，之后不再加锁
+    thread_local ThreadProfileBuffer* currentBuffer = nullptr;
+    std::thread::id mainThread;
+
+    const float SMOOTHING = 0.1f;               // 阶段耗时的指数平均系数
+    const int GPU_THREAD = 1000;                // 跟踪文件中 GPU 时间线的 tid
+
+    bool eventBefore(const ProfileEvent& a, const ProfileEvent& b)
+    {
+        return a.start < b.start || (a.start == b.start && a.depth < b.depth);
+    }
+}
+
+// 放在上面的静态变量之后，构造时它们已经初始化
+Profiler profiler;
+
+ThreadProfileBuffer::ThreadProfileBuffer(int id, const std::string& name)
+    : id(id), name(name), depth(0), head(0), tail(0), dropped(0)
+{
+}
+
+void ThreadProfileBuffer::push(const ProfileEvent& event)
+{
+    // 单生产者单消费者：写满时丢弃新事件，读取方不会读到正在写的槽位
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= CAPACITY)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    events[h & (CAPACITY - 1)] = event;
+    head.store(h + 1, std::memory_order_release);
+}
+
+Profiler::Profiler()
+    : epoch(std::chrono::steady_clock::now()), gpuFrameIndex(0), gpuOpen(false), gpuResolved(false), inFrame(false),
+      droppedEvents(0), historyHead(0), frameStart(0), frameNumber(0), traceFramesLeft(0)
+{
+    for (GpuFrame& frame : gpuFrames)
+    {
+        frame.used = 0;
+        frame.start = 0;
+    }
+    std::fill(frameMs, frameMs + HISTORY, 0.0f);
+
+    // 全局对象在主线程上构造，主线程总是 0 号
+    mainThread = std::this_thread::get_id();
+    setThreadName("main");
+}
+
+Profiler::~Profiler()
+{
+    if (traceFramesLeft > 0)
+        writeTrace();
+}
+
+uint64_t Profiler::now() const
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+ThreadProfileBuffer* Profiler::threadBuffer()
+{
+    if (currentBuffer)
+        return currentBuffer;
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    int id = (int)threads.size();
+    currentBuffer = bufferPool.create(id, "thread " + std::to_string(id));
+    threads.push_back(currentBuffer);
+    return currentBuffer;
+}
+
+void Profiler::setThreadName(const char* name)
+{
+    ThreadProfileBuffer* buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    buffer->name = name;
+}
+
+void Profiler::beginFrame()
+{
+    inFrame = true;
+    frameStart = now();
+
+    gpuFrameIndex = (gpuFrameIndex + 1) % GPU_FRAMES;
+    GpuFrame& frame = gpuFrames[gpuFrameIndex];
+    frame.used = 0;
+    frame.start = frameStart;
+}
+
+void Profiler::endFrame()
+{
+    if (!inFrame)
+        return;
+    inFrame = false;
+
+    frameMs[historyHead] = (now() - frameStart) * 1e-6f;
+    historyHead = (historyHead + 1) % HISTORY;
+    frameNumber++;
+
+    for (PassStats& pass : passes)
+    {
+        pass.cpuFrameMs = 0.0f;
+        pass.gpuFrameMs = 0.0f;
+    }
+
+    collectCpu();
+    // 上一帧的查询；本帧的留到下一帧再读，这时大多已经完成
+    collectGpu(gpuFrames[(gpuFrameIndex + GPU_FRAMES - 1) % GPU_FRAMES]);
+
+    for (PassStats& pass : passes)
+    {
+        pass.cpuMs += (pass.cpuFrameMs - pass.cpuMs) * SMOOTHING;
+        if (pass.hasGpu)
+            pass.gpuMs += (pass.gpuFrameMs - pass.gpuMs) * SMOOTHING;
+    }
+
+    if (traceFramesLeft > 0 && --traceFramesLeft == 0)
+        writeTrace();
+}
+
+Profiler::PassStats& Profiler::stats(const char* name, uint32_t depth)
+{
+    // 阶段只有十几个，线性查找；不同编译单元中相同的字符串常量地址可能不同，按内容比较
+    for (PassStats& pass : passes)
+    {
+        if (pass.name == name || strcmp(pass.name, name) == 0)
+            return pass;
+    }
+    PassStats pass = { name, depth, 0.0f, 0.0f, 0.0f, 0.0f, false };
+    passes.push_back(pass);
+    return passes.back();
+}
+
+void Profiler::collectCpu()
+{
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    for (ThreadProfileBuffer* buffer : threads)
+    {
+        droppedEvents += buffer->dropped.exchange(0, std::memory_order_relaxed);
+        uint32_t h = buffer->head.load(std::memory_order_acquire);
+        uint32_t t = buffer->tail.load(std::memory_order_relaxed);
+        if (h == t)
+            continue;
+
+        // 事件在作用域结束时写入，子段先于父段；按开始时间排序后新阶段按出现顺序加入列表
+        size_t first = frameEvents.size();
+        for (; t != h; t++)
+            frameEvents.push_back(buffer->events[t & (ThreadProfileBuffer::CAPACITY - 1)]);
+        buffer->tail.store(h, std::memory_order_release);
+        std::sort(frameEvents.begin() + first, frameEvents.end(), eventBefore);
+
+        for (size_t i = first; i < frameEvents.size(); i++)
+        {
+            const ProfileEvent& event = frameEvents[i];
+            stats(event.name, event.depth).cpuFrameMs += (event.end - event.start) * 1e-6f;
+            if (traceFramesLeft > 0)
+            {
+                TraceEvent trace = { event.name, event.start, event.end, buffer->id };
+                traceEvents.push_back(trace);
+            }
+        }
+    }
+    frameEvents.clear();
+}
+
+void Profiler::collectGpu(GpuFrame& frame)
+{
+    gpuResolved = false;
+    if (frame.used == 0)
+        return;
+
+    // 查询按提交顺序完成，最后一个就绪则全部就绪；没就绪就丢掉这一帧，绝不等待
+    GLint available = 0;
+    glGetQueryObjectiv(frame.queries[frame.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available)
+    {
+        gpuResolved = true;
+        // GL_TIME_ELAPSED 只有时长，跟踪文件中从该帧开始时刻依次排列
+        uint64_t cursor = frame.start;
+        for (size_t i = 0; i < frame.used; i++)
+        {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &elapsed);
+            PassStats& pass = stats(frame.names[i], 0);
+            pass.gpuFrameMs += elapsed * 1e-6f;
+            pass.hasGpu = true;
+            if (traceFramesLeft > 0)
+            {
+                TraceEvent trace = { frame.names[i], cursor, cursor + elapsed, -1 };
+                traceEvents.push_back(trace);
+            }
+            cursor += elapsed;
+        }
+    }
+    frame.used = 0;
+}
+
+bool Profiler::beginGpu(const char* name)
+{
+    // 查询对象属于主线程的上下文；计时查询不能嵌套
+    if (!inFrame || gpuOpen || std::this_thread::get_id() != mainThread)
+        return false;
+
+    GpuFrame& frame = gpuFrames[gpuFrameIndex];
+    if (frame.used == frame.queries.size())
+    {
+        unsigned int query;
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+        frame.names.push_back(name);
+    }
+    frame.names[frame.used] = name;
+    glBeginQuery(GL_TIME_ELAPSED, frame.queries[frame.used]);
+    frame.used++;
+    gpuOpen = true;
+    return true;
+}
+
+void Profiler::endGpu()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    gpuOpen = false;
+}
+
+bool Profiler::lastGpuMs(const char* const* names, size_t count, float* ms) const
+{
+    if (!gpuResolved)
+        return false;
+    float total = 0.0f;
+    for (const PassStats& pass : passes)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (pass.name == names[i] || strcmp(pass.name, names[i]) == 0)
+                total += pass.gpuFrameMs;
+        }
+    }
+    *ms = total;
+    return true;
+}
+
+void Profiler::captureTrace(const char* path, int frames)
+{
+    if (traceFramesLeft > 0)
+        return;
+    tracePath = path;
+    traceFramesLeft = frames;
+    traceEvents.clear();
+    std::cout << "Capturing " << frames << " frames to " << path << std::endl;
+}
+
+void Profiler::writeTrace()
+{
+    traceFramesLeft = 0;
+    FILE* file = fopen(tracePath.c_str(), "w");
+    if (!file)
+    {
+        std::cout << "ERROR::PROFILER::TRACE_WRITE_FAILED: " << tracePath << std::endl;
+        return;
+    }
+
+    // Chrome 跟踪格式：完整事件 "X"，时间单位为微秒
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (ThreadProfileBuffer* buffer : threads)
+            fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+                    buffer->id, buffer->name.c_str());
+    }
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"GPU\"}}", GPU_THREAD);
+    for (const TraceEvent& event : traceEvents)
+    {
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                event.name, event.thread < 0 ? GPU_THREAD : event.thread,
+                event.start * 1e-3, (event.end - event.start) * 1e-3);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    std::cout << "Profile trace written: " << tracePath << " (" << traceEvents.size() << " events)" << std::endl;
+    traceEvents.clear();
+}
+
+float Profiler::drawHud(HudOverlay& hud, float x, float y) const
+{
+    const glm::vec4 TEXT(0.9f, 0.9f, 0.9f, 1.0f);
+    const glm::vec4 DIM(0.6f, 0.6f, 0.65f, 1.0f);
+    const float line = hud.lineHeight();
+    const float width = hud.charWidth() * 34;
+    const float graphHeight = 40.0f;
+
+    float average = 0.0f;
+    float worst = 0.0f;
+    for (float ms : frameMs)
+    {
+        average += ms;
+        worst = std::max(worst, ms);
+    }
+    average /= HISTORY;
+
+    size_t lines = passes.size() + (droppedEvents ? 3 : 2);
+    hud.rect(x - 4.0f, y - 4.0f, width + 8.0f, line * lines + graphHeight + 12.0f, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+
+    char text[64];
+    snprintf(text, sizeof(text), "FRAME %6.2f MS  MAX %6.2f", average, worst);
+    hud.text(x, y, text, TEXT);
+    y += line;
+    hud.text(x, y, "PASS                  CPU     GPU", DIM);
+    y += line;
+    for (const PassStats& pass : passes)
+    {
+        // 名字按嵌套深度缩进，没有 GPU 段的阶段 GPU 列留空
+        int indent = (int)std::min(pass.depth, 4u);
+        if (pass.hasGpu)
+            snprintf(text, sizeof(text), "%*s%-*.*s %6.2f  %6.2f", indent, "", 18 - indent, 18 - indent, pass.name, pass.cpuMs, pass.gpuMs);
+        else
+            snprintf(text, sizeof(text), "%*s%-*.*s %6.2f", indent, "", 18 - indent, 18 - indent, pass.name, pass.cpuMs);
+        hud.text(x, y, text, TEXT);
+        y += line;
+    }
+
+    if (droppedEvents)
+    {
+        snprintf(text, sizeof(text), "DROPPED %llu EVENTS", droppedEvents);
+        hud.text(x, y, text, glm::vec4(0.9f, 0.3f, 0.3f, 1.0f));
+        y += line;
+    }
+
+    // 帧时间曲线：最旧的在左，33ms 满格；超过 16.7ms 变黄，超过 33.3ms 变红
+    y += 4.0f;
+    float barWidth = width / HISTORY;
+    for (int i = 0; i < HISTORY; i++)
+    {
+        float ms = frameMs[(historyHead + i) % HISTORY];
+        float h = std::min(ms / 33.3f, 1.0f) * graphHeight;
+        glm::vec4 color = ms > 33.3f ? glm::vec4(0.9f, 0.3f, 0.3f, 1.0f)
+                        : ms > 16.7f ? glm::vec4(0.9f, 0.8f, 0.3f, 1.0f)
+                                     : glm::vec4(0.4f, 0.8f, 0.4f, 1.0f);
+        hud.rect(x + i * barWidth, y + graphHeight - h, barWidth, h, color);
+    }
+    return y + graphHeight + 8.0f;
+}
+
+void Profiler::releaseGpu()
+{
+    for (GpuFrame& frame : gpuFrames)
+    {
+        if (!frame.queries.empty())
+            glDeleteQueries((GLsizei)frame.queries.size(), frame.queries.data());
+        frame.queries.clear();
+        frame.names.clear();
+        frame.used = 0;
+    }
+}
+
+CpuProfileScope::CpuProfileScope(const char* name)
+    : buffer(profiler.threadBuffer()), name(name), start(profiler.now())
+{
+    buffer->depth++;
+}
+
+CpuProfileScope::~CpuProfileScope()
+{
+    buffer->depth--;
+    ProfileEvent event = { name, start, profiler.now(), buffer->depth };
+    buffer->push(event);
+}
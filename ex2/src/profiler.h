@@ -0,0 +1,186 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "object_pool.h"
+
+class HudOverlay;
+
+// 帧内分段计时：CPU 段可嵌套、可在任意线程记录，GPU 段用 GL_TIME_ELAPSED 查询。
+//
+// CPU 段在作用域结束时写入本线程的环形缓冲（只有本线程写、主线程在帧末读，无锁），
+// GPU 段每帧一组查询、两组轮换，帧末只读取上一帧且已就绪的结果，从不等待GPU。
+// GL_TIME_ELAPSED 查询不能嵌套，GPU 段只用于主线程上互不重叠的绘制阶段，嵌套的 GPU 段被忽略。
+//
+// 代码中用 PROFILE_CPU / PROFILE_GPU / PROFILE_PASS 标记，未定义 ENABLE_PROFILER 时这些宏展开为空，没有任何开销。
+
+struct ProfileEvent
+{
+    const char* name;       // 必须是字符串常量，按指针聚合
+    uint64_t start;         // 纳秒，相对于分析器创建时刻
+    uint64_t end;
+    uint32_t depth;
+};
+
+// 每个线程一个，只有所属线程写入
+class ThreadProfileBuffer
+{
+public:
+    static const uint32_t CAPACITY = 4096;  // 2 的幂
+
+    ThreadProfileBuffer(int id, const std::string& name);
+
+    void push(const ProfileEvent& event);
+
+    int id;
+    std::string name;
+    uint32_t depth;                 // 当前嵌套深度，只有所属线程访问
+    std::atomic<uint32_t> head;     // 写入位置，只有所属线程修改
+    std::atomic<uint32_t> tail;     // 读取位置，只有主线程修改；写满时新事件丢弃而不覆盖未读的
+    std::atomic<uint32_t> dropped;
+    ProfileEvent events[CAPACITY];
+};
+
+class Profiler
+{
+public:
+    Profiler();
+    ~Profiler();
+
+    uint64_t now() const;
+
+    // 当前线程的缓冲，第一次调用时注册（加锁，仅一次）
+    ThreadProfileBuffer* threadBuffer();
+    void setThreadName(const char* name);
+
+    // 主线程每帧调用：beginFrame 在帧开始，endFrame 在交换缓冲之后
+    void beginFrame();
+    void endFrame();
+
+    bool beginGpu(const char* name);
+    void endGpu();
+    // 最近一次 endFrame 读取到的那一帧中，names 各 GPU 段的耗时之和（毫秒）；该帧结果没有就绪时返回 false
+    bool lastGpuMs(const char* const* names, size_t count, float* ms) const;
+
+    // 记录接下来 frames 帧的 CPU/GPU 段，完成后写成 Chrome 跟踪格式（chrome://tracing 或 Perfetto 打开）
+    void captureTrace(const char* path, int frames);
+    bool capturing() const { return traceFramesLeft > 0; }
+
+    // 左上角 (x, y) 开始绘制各阶段耗时与帧时间曲线，返回下方空白处的 y
+    float drawHud(HudOverlay& hud, float x, float y) const;
+
+    void releaseGpu();
+
+private:
+    static const int GPU_FRAMES = 2;
+    static const int HISTORY = 120;
+
+    struct GpuFrame
+    {
+        std::vector<unsigned int> queries;  // 只增不减，跨帧复用
+        std::vector<const char*> names;
+        size_t used;
+        uint64_t start;         // 该帧开始时刻，跟踪文件中 GPU 段从这里依次排列
+    };
+
+    // 各阶段的平滑耗时（毫秒），按首次出现的顺序显示
+    struct PassStats
+    {
+        const char* name;
+        uint32_t depth;
+        float cpuMs;
+        float gpuMs;
+        float cpuFrameMs;       // 本帧累计
+        float gpuFrameMs;
+        bool hasGpu;
+    };
+
+    struct TraceEvent
+    {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+        int thread;             // -1 表示 GPU
+    };
+
+    PassStats& stats(const char* name, uint32_t depth);
+    void collectCpu();
+    void collectGpu(GpuFrame& frame);
+    void writeTrace();
+
+    std::chrono::steady_clock::time_point epoch;
+
+    std::mutex threadsMutex;
+    // 缓冲地址在线程登记后保持不变，每块 8 个
+    ObjectPool<ThreadProfileBuffer, 8> bufferPool;
+    std::vector<ThreadProfileBuffer*> threads;
+
+    GpuFrame gpuFrames[GPU_FRAMES];
+    int gpuFrameIndex;
+    bool gpuOpen;               // 有一个 GPU 段正在计时
+    bool gpuResolved;           // 最近一次 endFrame 读到了一帧 GPU 结果
+    bool inFrame;
+
+    std::vector<ProfileEvent> frameEvents;  // 帧末收集时的临时数组
+    std::vector<PassStats> passes;
+    unsigned long long droppedEvents;
+    float frameMs[HISTORY];     // 帧时间环形历史
+    int historyHead;
+    uint64_t frameStart;
+    unsigned long long frameNumber;
+
+    std::string tracePath;
+    int traceFramesLeft;
+    std::vector<TraceEvent> traceEvents;
+};
+
+extern Profiler profiler;
+
+// RAII 标记
+class CpuProfileScope
+{
+public:
+    explicit CpuProfileScope(const char* name);
+    ~CpuProfileScope();
+
+private:
+    ThreadProfileBuffer* buffer;
+    const char* name;
+    uint64_t start;
+};
+
+class GpuProfileScope
+{
+public:
+    explicit GpuProfileScope(const char* name) : active(profiler.beginGpu(name)) {}
+    ~GpuProfileScope()
+    {
+        if (active)
+            profiler.endGpu();
+    }
+
+private:
+    bool active;
+};
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_CPU(name) CpuProfileScope PROFILE_CONCAT(cpuProfileScope, __LINE__)(name)
+#define PROFILE_GPU(name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+#define PROFILE_PASS(name) PROFILE_CPU(name); PROFILE_GPU(name)
+#define PROFILE_THREAD_NAME(name) profiler.setThreadName(name)
+#else
+#define PROFILE_CPU(name) ((void)0)
+#define PROFILE_GPU(name) ((void)0)
+#define PROFILE_PASS(name) ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
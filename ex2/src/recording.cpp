@@ -0,0 +1,536 @@
+#include "recording.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char MAGIC[8] = { 'S', 'E', 'M', 'R', 'E', 'C', '1', '\0' };
+    const uint32_t VERSION = 1;
+    const size_t HEADER_SIZE = 40;
+    const size_t INDEX_OFFSET_POS = 32;
+    const size_t VALUES_PER_BODY = 4;   // x, y, z, spin
+    const uint32_t MAX_BODIES = 1u << 20;   // 回放前按天体数分配解码状态，文件头超出时视为无效
+    const double TWO_PI = 6.28318530717958647692;
+    const double TIME_STEP = 1e-6;      // 模拟时间量化为微秒
+
+    // 第 i 个值是否为 16 位环绕的自转角
+    inline bool isSpinValue(size_t i)
+    {
+        return i > 0 && (i - 1) % VALUES_PER_BODY == 3;
+    }
+
+    inline int64_t wrap16(int64_t v)
+    {
+        return (int64_t)(int16_t)(uint16_t)(v & 0xFFFF);
+    }
+
+    inline void putVarint(std::vector<unsigned char>& out, int64_t value)
+    {
+        uint64_t v = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); // zigzag
+        while (v >= 0x80)
+        {
+            out.push_back((unsigned char)(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((unsigned char)v);
+    }
+
+    inline bool getVarint(const unsigned char*& p, const unsigned char* end, int64_t* value)
+    {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (p >= end)
+                return false;
+            unsigned char b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80))
+            {
+                *value = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename T>
+    inline void putRaw(std::ofstream& out, const T& value)
+    {
+        out.write((const char*)&value, sizeof(T));
+    }
+
+    template <typename T>
+    inline T getRaw(const unsigned char* p)
+    {
+        T value;
+        memcpy(&value, p, sizeof(T));
+        return value;
+    }
+
+    // offset 处的数据块（8 字节块头 + 数据）是否完整位于文件内；比较时不做可能溢出的加法
+    inline bool chunkInFile(const unsigned char* data, size_t size, uint64_t offset)
+    {
+        if (offset < HEADER_SIZE || offset > size || size - offset < 8)
+            return false;
+        uint32_t ticks = getRaw<uint32_t>(data + offset);
+        uint32_t bytes = getRaw<uint32_t>(data + offset + 4);
+        return ticks > 0 && bytes <= size - offset - 8;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SimulationRecorder
+
+SimulationRecorder::SimulationRecorder()
+    : bodies(0), chunkTicks(0), step(0.0), ticksInChunk(0), chunkFirstTime(0.0),
+      totalTicks(0), fileBytes(0)
+{
+}
+
+SimulationRecorder::~SimulationRecorder()
+{
+    close();
+}
+
+bool SimulationRecorder::open(const char* path, unsigned int bodyCount,
+                              unsigned int ticksPerChunk, double positionStep)
+{
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cout << "ERROR::RECORDING::CANNOT_OPEN_FILE: " << path << std::endl;
+        return false;
+    }
+
+    bodies = bodyCount;
+    chunkTicks = ticksPerChunk > 0 ? ticksPerChunk : 1;
+    step = positionStep;
+    previous.assign(1 + bodies * VALUES_PER_BODY, 0);
+    previousDelta.assign(previous.size(), 0);
+    payload.clear();
+    index.clear();
+    ticksInChunk = 0;
+    totalTicks = 0;
+
+    file.write(MAGIC, sizeof(MAGIC));
+    putRaw(file, VERSION);
+    putRaw(file, (uint32_t)bodies);
+    putRaw(file, (uint32_t)chunkTicks);
+    putRaw(file, (uint32_t)0);
+    putRaw(file, step);
+    putRaw(file, (uint64_t)0);      // 索引位置，关闭时回填
+    fileBytes = HEADER_SIZE;
+    return true;
+}
+
+void SimulationRecorder::writeTick(double simTime, const RecordedBody* states)
+{
+    if (!file.is_open())
+        return;
+
+    if (ticksInChunk == 0)
+        chunkFirstTime = simTime;
+
+    for (size_t i = 0; i < previous.size(); i++)
+    {
+        int64_t value;
+        if (i == 0)
+        {
+            value = (int64_t)std::llround(simTime / TIME_STEP);
+        }
+        else
+        {
+            const RecordedBody& b = states[(i - 1) / VALUES_PER_BODY];
+            switch ((i - 1) % VALUES_PER_BODY)
+            {
+            case 0: value = (int64_t)std::llround(b.relPos.x / step); break;
+            case 1: value = (int64_t)std::llround(b.relPos.y / step); break;
+            case 2: value = (int64_t)std::llround(b.relPos.z / step); break;
+            default:
+                value = (int64_t)std::llround(b.spinAngle / TWO_PI * 65536.0) & 0xFFFF;
+                break;
+            }
+        }
+
+        // 关键帧存绝对值，第二帧存一阶差分，之后存二阶差分
+        int64_t delta = value - previous[i];
+        if (isSpinValue(i))
+            delta = wrap16(delta);
+        if (ticksInChunk == 0)
+        {
+            putVarint(payload, value);
+            delta = 0;
+        }
+        else if (ticksInChunk == 1)
+        {
+            putVarint(payload, delta);
+        }
+        else
+        {
+            int64_t dd = delta - previousDelta[i];
+            putVarint(payload, isSpinValue(i) ? wrap16(dd) : dd);
+        }
+        previous[i] = value;
+        previousDelta[i] = delta;
+    }
+
+    ticksInChunk++;
+    totalTicks++;
+    if (ticksInChunk == chunkTicks)
+        flushChunk();
+}
+
+void SimulationRecorder::flushChunk()
+{
+    if (ticksInChunk == 0)
+        return;
+
+    IndexEntry entry;
+    entry.firstTick = totalTicks - ticksInChunk;
+    entry.fileOffset = fileBytes;
+    entry.firstTime = chunkFirstTime;
+    index.push_back(entry);
+
+    putRaw(file, (uint32_t)ticksInChunk);
+    putRaw(file, (uint32_t)payload.size());
+    file.write((const char*)payload.data(), payload.size());
+    fileBytes += 8 + payload.size();
+
+    payload.clear();
+    ticksInChunk = 0;
+}
+
+void SimulationRecorder::close()
+{
+    if (!file.is_open())
+        return;
+
+    flushChunk();
+
+    uint64_t indexOffset = fileBytes;
+    putRaw(file, (uint64_t)index.size());
+    for (const IndexEntry& e : index)
+    {
+        putRaw(file, e.firstTick);
+        putRaw(file, e.fileOffset);
+        putRaw(file, e.firstTime);
+    }
+    fileBytes += 8 + index.size() * 24;
+
+    file.seekp(INDEX_OFFSET_POS);
+    putRaw(file, indexOffset);
+    file.close();
+}
+
+// ---------------------------------------------------------------------------
+// SimulationReplay
+
+SimulationReplay::SimulationReplay()
+    : data(nullptr), size(0),
+#ifdef _WIN32
+      fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr),
+#else
+      fd(-1),
+#endif
+      bodies(0), step(0.0), totalTicks(0), chunk(0), cursor(nullptr), chunkEnd(nullptr),
+      chunkTickCount(0), tickInChunk(0), tick(0)
+{
+}
+
+SimulationReplay::~SimulationReplay()
+{
+    close();
+}
+
+bool SimulationReplay::open(const char* path)
+{
+    close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                             FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(fileHandle, &fileSize);
+        size = (size_t)fileSize.QuadPart;
+        mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mappingHandle)
+            data = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    fd = ::open(path, O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        size = (size_t)st.st_size;
+        void* p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            data = (const unsigned char*)p;
+            madvise(p, size, MADV_SEQUENTIAL);
+        }
+    }
+#endif
+
+    if (!data)
+    {
+        std::cout << "ERROR::REPLAY::CANNOT_MAP_FILE: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    if (size < HEADER_SIZE || memcmp(data, MAGIC, sizeof(MAGIC)) != 0
+        || getRaw<uint32_t>(data + 8) != VERSION)
+    {
+        std::cout << "ERROR::REPLAY::INVALID_FILE: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    bodies = getRaw<uint32_t>(data + 12);
+    if (bodies > MAX_BODIES)
+    {
+        std::cout << "ERROR::REPLAY::INVALID_FILE: " << bodies << " bodies in " << path << std::endl;
+        close();
+        return false;
+    }
+    step = getRaw<double>(data + 24);
+    uint64_t indexOffset = getRaw<uint64_t>(data + INDEX_OFFSET_POS);
+
+    index.clear();
+    bool indexValid = false;
+    if (indexOffset >= HEADER_SIZE && indexOffset <= size && size - indexOffset >= 8)
+    {
+        // 条目数来自文件，用除法比较，损坏的大数值不会溢出绕过检查
+        uint64_t count = getRaw<uint64_t>(data + indexOffset);
+        if (count <= (size - indexOffset - 8) / 24)
+        {
+            const unsigned char* p = data + indexOffset + 8;
+            for (uint64_t i = 0; i < count; i++, p += 24)
+            {
+                IndexEntry e;
+                e.firstTick = getRaw<uint64_t>(p);
+                e.fileOffset = getRaw<uint64_t>(p + 8);
+                e.firstTime = getRaw<double>(p + 16);
+                if (!chunkInFile(data, size, e.fileOffset))
+                {
+                    std::cout << "ERROR::REPLAY::CORRUPT_INDEX: chunk " << i << " lies outside " << path << std::endl;
+                    close();
+                    return false;
+                }
+                index.push_back(e);
+            }
+            indexValid = true;
+        }
+    }
+
+    // 录制未正常结束时没有索引，顺序扫描数据块重建
+    if (!indexValid && !buildIndexByScan())
+    {
+        std::cout << "ERROR::REPLAY::CORRUPT_FILE: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // 关键帧每个值至少占 1 字节，第一个数据块装不下一帧时天体数与文件内容不符
+    size_t valuesPerTick = 1 + (size_t)bodies * VALUES_PER_BODY;
+    if (!index.empty() && getRaw<uint32_t>(data + index.front().fileOffset + 4) < valuesPerTick)
+    {
+        std::cout << "ERROR::REPLAY::INVALID_FILE: body count does not match the data in " << path << std::endl;
+        close();
+        return false;
+    }
+
+    totalTicks = 0;
+    if (!index.empty())
+    {
+        const unsigned char* last = data + index.back().fileOffset;
+        totalTicks = index.back().firstTick + getRaw<uint32_t>(last);
+    }
+
+    previous.assign(valuesPerTick, 0);
+    previousDelta.assign(previous.size(), 0);
+    scratch.resize(bodies);
+    return seekTick(0) || totalTicks == 0;
+}
+
+bool SimulationReplay::buildIndexByScan()
+{
+    size_t offset = HEADER_SIZE;
+    uint64_t firstTick = 0;
+    while (offset + 8 <= size)
+    {
+        if (!chunkInFile(data, size, offset))
+            break;
+        uint32_t ticks = getRaw<uint32_t>(data + offset);
+        uint32_t bytes = getRaw<uint32_t>(data + offset + 4);
+
+        // 关键帧的第一个值就是该块起始时间
+        const unsigned char* p = data + offset + 8;
+        int64_t micros = 0;
+        if (!getVarint(p, p + bytes, &micros))
+            break;
+
+        IndexEntry e;
+        e.firstTick = firstTick;
+        e.fileOffset = offset;
+        e.firstTime = micros * TIME_STEP;
+        index.push_back(e);
+
+        firstTick += ticks;
+        offset += 8 + bytes;
+    }
+    return !index.empty();
+}
+
+void SimulationReplay::close()
+{
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (data)
+        munmap((void*)data, size);
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+    size = 0;
+    index.clear();
+    totalTicks = 0;
+    cursor = chunkEnd = nullptr;
+}
+
+bool SimulationReplay::beginChunk(size_t c)
+{
+    if (c >= index.size() || !chunkInFile(data, size, index[c].fileOffset))
+        return false;
+
+    const unsigned char* header = data + index[c].fileOffset;
+    chunk = c;
+    chunkTickCount = getRaw<uint32_t>(header);
+    cursor = header + 8;
+    chunkEnd = cursor + getRaw<uint32_t>(header + 4);
+    tickInChunk = 0;
+    tick = index[c].firstTick;
+    return true;
+}
+
+bool SimulationReplay::seekTick(unsigned long long target)
+{
+    if (index.empty() || target >= totalTicks)
+        return false;
+
+    // 二分查找目标帧所在的数据块
+    size_t lo = 0, hi = index.size();
+    while (hi - lo > 1)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (index[mid].firstTick <= target)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    if (!beginChunk(lo))
+        return false;
+
+    // 块内只能从关键帧顺序解码到目标帧
+    double t;
+    while (tick < target)
+    {
+        if (!nextTick(&t, scratch.data()))
+            return false;
+    }
+    return true;
+}
+
+bool SimulationReplay::seekTime(double time)
+{
+    if (index.empty())
+        return false;
+
+    size_t lo = 0, hi = index.size();
+    while (hi - lo > 1)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (index[mid].firstTime <= time)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return beginChunk(lo);
+}
+
+bool SimulationReplay::nextTick(double* simTime, RecordedBody* out)
+{
+    if (!data)
+        return false;
+    if (tickInChunk == chunkTickCount && !beginChunk(chunk + 1))
+        return false;
+
+    for (size_t i = 0; i < previous.size(); i++)
+    {
+        int64_t v;
+        if (!getVarint(cursor, chunkEnd, &v))
+            return false;
+
+        int64_t value;
+        int64_t delta;
+        if (tickInChunk == 0)
+        {
+            value = v;
+            delta = 0;
+        }
+        else
+        {
+            delta = tickInChunk == 1 ? v : previousDelta[i] + v;
+            if (isSpinValue(i))
+                delta = wrap16(delta);
+            value = previous[i] + delta;
+            if (isSpinValue(i))
+                value &= 0xFFFF;
+        }
+        previous[i] = value;
+        previousDelta[i] = delta;
+
+        if (i == 0)
+        {
+            *simTime = value * TIME_STEP;
+        }
+        else
+        {
+            RecordedBody& b = out[(i - 1) / VALUES_PER_BODY];
+            switch ((i - 1) % VALUES_PER_BODY)
+            {
+            case 0: b.relPos.x = value * step; break;
+            case 1: b.relPos.y = value * step; break;
+            case 2: b.relPos.z = value * step; break;
+            default: b.spinAngle = value / 65536.0 * TWO_PI; break;
+            }
+        }
+    }
+
+    tickInChunk++;
+    tick++;
+    return true;
+}
@@ -0,0 +1,132 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 模拟录制与回放
+//
+// 文件格式（小端）：
+//   文件头  : "SEMREC1\0" | version | bodyCount | ticksPerChunk | 保留 | positionStep | indexOffset
+//   数据块  : tickCount(u32) | payloadBytes(u32) | payload
+//   索引    : chunkCount(u64) | { firstTick(u64), fileOffset(u64), firstTime(f64) } * chunkCount
+//
+// 每个数据块第一帧为关键帧（绝对量化值），第二帧存一阶差分，之后存二阶差分，
+// 所有整数用 zigzag + 变长编码。轨道运动平滑，二阶差分大多只占 1 字节。
+// 位置按 positionStep 量化为整数，自转角量化为 16 位。
+
+// 一个天体在某一帧的状态
+struct RecordedBody
+{
+    glm::dvec3 relPos;      // 相对父天体位置
+    double spinAngle;       // 自转角（弧度）
+};
+
+class SimulationRecorder
+{
+public:
+    SimulationRecorder();
+    ~SimulationRecorder();
+
+    bool open(const char* path, unsigned int bodyCount,
+              unsigned int ticksPerChunk = 256, double positionStep = 1.0 / 65536.0);
+    // 写入一帧，bodies 长度必须等于 bodyCount
+    void writeTick(double simTime, const RecordedBody* bodies);
+    // 写出最后一个数据块和索引
+    void close();
+
+    bool isOpen() const { return file.is_open(); }
+    unsigned long long tickCount() const { return totalTicks; }
+    unsigned long long bytesWritten() const { return fileBytes; }
+
+private:
+    struct IndexEntry
+    {
+        uint64_t firstTick;
+        uint64_t fileOffset;
+        double firstTime;
+    };
+
+    void flushChunk();
+
+    std::ofstream file;
+    unsigned int bodies;
+    unsigned int chunkTicks;
+    double step;
+
+    std::vector<unsigned char> payload;
+    std::vector<int64_t> previous;      // 上一帧的量化值
+    std::vector<int64_t> previousDelta; // 上一帧的一阶差分
+    std::vector<IndexEntry> index;
+    unsigned int ticksInChunk;
+    double chunkFirstTime;
+    unsigned long long totalTicks;
+    unsigned long long fileBytes;
+};
+
+// 通过内存映射读取录制文件，按帧顺序解码，支持按帧号或模拟时间跳转
+class SimulationReplay
+{
+public:
+    SimulationReplay();
+    ~SimulationReplay();
+
+    bool open(const char* path);
+    void close();
+
+    unsigned int bodyCount() const { return bodies; }
+    unsigned long long tickCount() const { return totalTicks; }
+    double startTime() const { return index.empty() ? 0.0 : index.front().firstTime; }
+
+    // 跳到第 tick 帧，下一次 nextTick() 返回该帧
+    bool seekTick(unsigned long long tick);
+    // 跳到模拟时间不小于 time 的第一帧所在的数据块起点
+    bool seekTime(double time);
+
+    // 解码下一帧，到达文件末尾返回 false
+    bool nextTick(double* simTime, RecordedBody* out);
+    unsigned long long currentTick() const { return tick; }
+
+private:
+    struct IndexEntry
+    {
+        uint64_t firstTick;
+        uint64_t fileOffset;
+        double firstTime;
+    };
+
+    bool buildIndexByScan();
+    bool beginChunk(size_t chunk);
+
+    // 内存映射
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+
+    unsigned int bodies;
+    double step;
+    std::vector<IndexEntry> index;
+    unsigned long long totalTicks;
+
+    // 解码状态
+    size_t chunk;
+    const unsigned char* cursor;
+    const unsigned char* chunkEnd;
+    unsigned int chunkTickCount;
+    unsigned int tickInChunk;
+    unsigned long long tick;
+    std::vector<int64_t> previous;
+    std::vector<int64_t> previousDelta;
+    std::vector<RecordedBody> scratch;  // seekTick 跳过的帧解码到这里，open 时按天体数分配一次
+};
+
+#endif // RECORDING_H
@@ -0,0 +1,195 @@
+#include "render_queue.h"
+
+#include "frame_arena.h"
+#include "profiler.h"
+
+#include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+RenderStateCache::RenderStateCache()
+    : program(0), vao(0), texture(0), programValid(false), vaoValid(false), textureValid(false),
+      changeCount(0), avoidedCount(0)
+{
+}
+
+void RenderStateCache::invalidate()
+{
+    programValid = vaoValid = textureValid = false;
+    for (UniformSlot& slot : uniforms)
+        slot.valid = false;
+}
+
+void RenderStateCache::useProgram(unsigned int newProgram)
+{
+    if (programValid && program == newProgram)
+    {
+        avoidedCount++;
+        return;
+    }
+    glUseProgram(newProgram);
+    program = newProgram;
+    programValid = true;
+    changeCount++;
+}
+
+void RenderStateCache::bindVertexArray(unsigned int newVao)
+{
+    if (vaoValid && vao == newVao)
+    {
+        avoidedCount++;
+        return;
+    }
+    glBindVertexArray(newVao);
+    vao = newVao;
+    vaoValid = true;
+    changeCount++;
+}
+
+void RenderStateCache::bindTexture(unsigned int newTexture)
+{
+    if (textureValid && texture == newTexture)
+    {
+        avoidedCount++;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, newTexture);
+    texture = newTexture;
+    textureValid = true;
+    changeCount++;
+}
+
+RenderStateCache::UniformSlot& RenderStateCache::slot(const char* name)
+{
+    for (UniformSlot& slot : uniforms)
+    {
+        if (slot.program == program && (slot.name == name || strcmp(slot.name, name) == 0))
+            return slot;
+    }
+    UniformSlot slot = { program, name, glGetUniformLocation(program, name), 0, false };
+    uniforms.push_back(slot);
+    return uniforms.back();
+}
+
+void RenderStateCache::setUniform(const char* name, int value)
+{
+    UniformSlot& uniform = slot(name);
+    if (uniform.valid && uniform.value == value)
+    {
+        avoidedCount++;
+        return;
+    }
+    glUniform1i(uniform.location, value);
+    uniform.value = value;
+    uniform.valid = true;
+    changeCount++;
+}
+
+void RenderStateCache::setUniform(const char* name, const glm::vec3& value)
+{
+    glUniform3fv(slot(name).location, 1, glm::value_ptr(value));
+}
+
+void RenderStateCache::setUniform(const char* name, const glm::mat4& value)
+{
+    glUniformMatrix4fv(slot(name).location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+uint64_t RenderQueue::makeKey(unsigned int pass, unsigned int program, unsigned int texture, float depth01, unsigned int sequence)
+{
+    const uint64_t DEPTH_MAX = (1u << 24) - 1;
+    uint64_t depth = (uint64_t)(std::min(std::max(depth01, 0.0f), 1.0f) * DEPTH_MAX);
+    return ((uint64_t)(pass & 0xF) << 60)
+         | ((uint64_t)(program & 0xFF) << 52)
+         | ((uint64_t)(texture & 0xFFF) << 40)
+         | (depth << 16)
+         | (uint64_t)(sequence & 0xFFFF);
+}
+
+RenderQueue::RenderQueue()
+    : commands(NULL), keys(NULL), order(NULL), keyScratch(NULL), orderScratch(NULL), count(0), capacity(0)
+{
+}
+
+void RenderQueue::begin(FrameArena& arena, size_t maxCommands)
+{
+    commands = arena.allocArray<RenderCommand>(maxCommands);
+    keys = arena.allocArray<uint64_t>(maxCommands);
+    order = arena.allocArray<uint32_t>(maxCommands);
+    keyScratch = arena.allocArray<uint64_t>(maxCommands);
+    orderScratch = arena.allocArray<uint32_t>(maxCommands);
+    count = 0;
+    capacity = maxCommands;
+}
+
+void RenderQueue::add(const RenderCommand& command, float depth01, unsigned int pass)
+{
+    // 半透明物体需要由远到近绘制，深度取反
+    assert(count < capacity);
+    if (count >= capacity)
+        return;
+    if (pass >= PASS_TRANSPARENT)
+        depth01 = 1.0f - depth01;
+    keys[count] = makeKey(pass, command.program, command.texture, depth01, (unsigned int)count);
+    new (&commands[count]) RenderCommand(command);
+    count++;
+}
+
+void RenderQueue::radixSort()
+{
+    size_t n = count;
+    for (size_t i = 0; i < n; i++)
+        order[i] = (uint32_t)i;
+
+    // 低位优先，每趟 8 位；所有键在某个字节上相同时跳过这一趟
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256] = { 0 };
+        for (size_t i = 0; i < n; i++)
+            histogram[(keys[i] >> shift) & 0xFF]++;
+        if (histogram[(keys[0] >> shift) & 0xFF] == n)
+            continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            size_t c = histogram[b];
+            histogram[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t dst = histogram[(keys[i] >> shift) & 0xFF]++;
+            keyScratch[dst] = keys[i];
+            orderScratch[dst] = order[i];
+        }
+        std::swap(keys, keyScratch);
+        std::swap(order, orderScratch);
+    }
+}
+
+void RenderQueue::submit(RenderStateCache& cache)
+{
+    PROFILE_CPU("render queue");
+    if (count == 0)
+        return;
+    radixSort();
+
+    cache.invalidate();
+    for (size_t i = 0; i < count; i++)
+    {
+        const RenderCommand& cmd = commands[order[i]];
+        cache.useProgram(cmd.program);
+        cache.bindVertexArray(cmd.vao);
+        cache.bindTexture(cmd.texture);
+        cache.setUniform("model", cmd.model);
+        cache.setUniform("objectColor", cmd.color);
+        if (cmd.indexed)
+            glDrawElements(cmd.mode, cmd.count, GL_UNSIGNED_INT, 0);
+        else
+            glDrawArrays(cmd.mode, 0, cmd.count);
+    }
+}
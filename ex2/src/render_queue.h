@@ -0,0 +1,109 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+class FrameArena;
+
+// 记录当前绑定的程序、VAO、纹理和整数uniform，跳过与当前状态相同的GL调用
+class RenderStateCache
+{
+public:
+    RenderStateCache();
+
+    // 其他代码直接调用过GL后需要失效，下一次设置一定会发出
+    void invalidate();
+
+    void useProgram(unsigned int program);
+    void bindVertexArray(unsigned int vao);
+    void bindTexture(unsigned int texture);     // GL_TEXTURE_2D，当前纹理单元
+    void setUniform(const char* name, int value);
+    // 每次都会设置（矩阵、颜色每个物体都不同），只缓存位置
+    void setUniform(const char* name, const glm::vec3& value);
+    void setUniform(const char* name, const glm::mat4& value);
+
+    size_t changes() const { return changeCount; }
+    size_t avoided() const { return avoidedCount; }
+    void resetCounters() { changeCount = avoidedCount = 0; }
+
+private:
+    struct UniformSlot
+    {
+        unsigned int program;
+        const char* name;   // 只保存指针，调用方传入字符串字面量
+        int location;
+        int value;
+        bool valid;
+    };
+
+    // 查找当前程序的uniform，第一次使用时查询位置
+    UniformSlot& slot(const char* name);
+
+    unsigned int program;
+    unsigned int vao;
+    unsigned int texture;
+    bool programValid;
+    bool vaoValid;
+    bool textureValid;
+    std::vector<UniformSlot> uniforms;
+    size_t changeCount;
+    size_t avoidedCount;
+};
+
+// 一次绘制所需的全部状态
+struct RenderCommand
+{
+    unsigned int program;
+    unsigned int vao;
+    unsigned int texture;
+    unsigned int mode;      // GL_TRIANGLES、GL_TRIANGLE_STRIP 等
+    int count;
+    bool indexed;           // glDrawElements（GL_UNSIGNED_INT）或 glDrawArrays
+    glm::mat4 model;
+    glm::vec3 color;
+};
+
+// 渲染队列：每帧收集绘制命令，按 64 位排序键基数排序后通过状态缓存提交。
+//
+// 排序键从高位到低位：通道(4) | 程序(8) | 纹理(12) | 由近到远的深度(24) | 提交顺序(16)。
+// 程序和纹理直接取GL对象名的低位，名字很大时只影响排序效果，不影响正确性。
+// 命令、排序键和排序用的临时数组每帧从帧分配器中分配，帧内不会扩容。
+class RenderQueue
+{
+public:
+    enum Pass
+    {
+        PASS_OPAQUE = 0,
+        PASS_TRANSPARENT = 8,
+    };
+
+    // depth01 为 [0, 1] 的归一化观察距离，越小越先绘制
+    static uint64_t makeKey(unsigned int pass, unsigned int program, unsigned int texture, float depth01, unsigned int sequence);
+
+    RenderQueue();
+
+    // 每帧开始收集前调用，清空队列并按最多 capacity 条命令分配数组；超出的命令被丢弃
+    void begin(FrameArena& arena, size_t capacity);
+    void add(const RenderCommand& command, float depth01, unsigned int pass = PASS_OPAQUE);
+
+    // 排序并提交全部命令；提交前状态缓存会失效
+    void submit(RenderStateCache& cache);
+
+    size_t size() const { return count; }
+
+private:
+    void radixSort();
+
+    RenderCommand* commands;
+    uint64_t* keys;
+    uint32_t* order;
+    uint64_t* keyScratch;
+    uint32_t* orderScratch;
+    size_t count;
+    size_t capacity;
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,390 @@
+#include "render_stats.h"
+
+#include "gl_ext.h"
+#include "hud_overlay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+RenderStats renderStats;
+
+const char* const RENDER_COUNTER_NAMES[RENDER_COUNTER_COUNT] = {
+    "draw_calls", "triangles", "indirect_commands", "dispatches", "program_binds",
+    "texture_binds", "vao_binds", "uniform_uploads", "buffer_bytes", "texture_bytes"
+};
+
+namespace
+{
+    uint64_t nowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    uint64_t triangles(GLenum mode, GLsizei count)
+    {
+        if (mode == GL_TRIANGLES)
+            return count / 3;
+        if (mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN)
+            return count > 2 ? count - 2 : 0;
+        return 0;
+    }
+
+    // 忽略 GL_UNPACK_ALIGNMENT 的行对齐，按紧密排列估算
+    uint64_t pixelBytes(GLenum format, GLenum type)
+    {
+        switch (type)
+        {
+        case GL_UNSIGNED_SHORT_5_6_5:
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+            return 2;
+        case GL_UNSIGNED_INT_8_8_8_8:
+        case GL_UNSIGNED_INT_8_8_8_8_REV:
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+        case GL_UNSIGNED_INT_24_8:
+        case GL_UNSIGNED_INT_10F_11F_11F_REV:
+            return 4;
+        }
+
+        uint64_t components = 4;
+        if (format == GL_RED || format == GL_RED_INTEGER || format == GL_DEPTH_COMPONENT)
+            components = 1;
+        else if (format == GL_RG || format == GL_RG_INTEGER)
+            components = 2;
+        else if (format == GL_RGB || format == GL_BGR || format == GL_RGB_INTEGER)
+            components = 3;
+
+        uint64_t size = 1;
+        if (type == GL_SHORT || type == GL_UNSIGNED_SHORT || type == GL_HALF_FLOAT)
+            size = 2;
+        else if (type == GL_INT || type == GL_UNSIGNED_INT || type == GL_FLOAT)
+            size = 4;
+        return components * size;
+    }
+
+    // ---- 包装函数：计数后调用原来的入口 ----
+
+    PFNGLDRAWARRAYSPROC realDrawArrays = NULL;
+    PFNGLDRAWELEMENTSPROC realDrawElements = NULL;
+    PFNGLDRAWARRAYSINSTANCEDPROC realDrawArraysInstanced = NULL;
+    PFNGLDRAWELEMENTSINSTANCEDPROC realDrawElementsInstanced = NULL;
+    PFNGLMULTIDRAWARRAYSPROC realMultiDrawArrays = NULL;
+    PFNGLMULTIDRAWELEMENTSPROC realMultiDrawElements = NULL;
+    PFNGLDRAWARRAYSINDIRECTPROC realDrawArraysIndirect = NULL;
+    PFNGLMULTIDRAWELEMENTSINDIRECTPROC realMultiDrawElementsIndirect = NULL;
+    PFNGLDISPATCHCOMPUTEPROC realDispatchCompute = NULL;
+    PFNGLUSEPROGRAMPROC realUseProgram = NULL;
+    PFNGLBINDTEXTUREPROC realBindTexture = NULL;
+    PFNGLBINDVERTEXARRAYPROC realBindVertexArray = NULL;
+    PFNGLBUFFERDATAPROC realBufferData = NULL;
+    PFNGLBUFFERSUBDATAPROC realBufferSubData = NULL;
+    PFNGLTEXIMAGE2DPROC realTexImage2D = NULL;
+    PFNGLTEXSUBIMAGE2DPROC realTexSubImage2D = NULL;
+
+    void APIENTRY countDrawArrays(GLenum mode, GLint first, GLsizei count)
+    {
+        renderStats.add(STAT_DRAW_CALLS, 1);
+        renderStats.add(STAT_TRIANGLES, triangles(mode, count));
+        realDrawArrays(mode, first, count);
+    }
+
+    void APIENTRY countDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+    {
+        renderStats.add(STAT_DRAW_CALLS, 1);
+        renderStats.add(STAT_TRIANGLES, triangles(mode, count));
+        realDrawElements(mode, count, type, indices);
+    }
+
+    void APIENTRY countDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+    {
+        renderStats.add(STAT_DRAW_CALLS, 1);
+        renderStats.add(STAT_TRIANGLES, triangles(mode, count) * instances);
+        realDrawArraysInstanced(mode, first, count, instances);
+    }
+
+    void APIENTRY countDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances)
+    {
+        renderStats.add(STAT_DRAW_CALLS, 1);
+        renderStats.add(STAT_TRIANGLES, triangles(mode, count) * instances);
+        realDrawElementsInstanced(mode, count, type, indices, instances);
+    }
+
+    void APIENTRY countMultiDrawArrays(GLenum mode, const GLint* first, const GLsizei* count, GLsizei drawcount)
+    {
+        renderStats.add(STAT_DRAW_CALLS, 1);
+        for (GLsizei i = 0; i < drawcount; i++)
+            renderStats.add(STAT_TRIANGLES, triangles(mode, count[i]));
+        realMultiDrawArrays(mode, first, count, drawcount);
+    }
+
+    void APIENTRY countMultiDrawElements(GLenum mode, const GLsizei* count, GLenum type, const void* const* indices, GLsizei drawcount)
+    {
+        renderStats.add(STAT_DRAW_CALLS, 1);
+        for (GLsizei i = 0; i < drawcount; i++)
+            renderStats.add(STAT_TRIANGLES, triangles(mode, count[i]));
+        realMultiDrawElements(mode, count, type, indices, drawcount);
+    }
+
+    void APIENTRY countDrawArraysIndirect(GLenum mode, const void* indirect)
+    {
+        renderStats.add(STAT_DRAW_CALLS, 1);
+        renderStats.add(STAT_INDIRECT_COMMANDS, 1);
+        realDrawArraysIndirect(mode, indirect);
+    }
+
+    void APIENTRY countMultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)
+    {
+        renderStats.add(STAT_DRAW_CALLS, 1);
+        renderStats.add(STAT_INDIRECT_COMMANDS, drawcount);
+        realMultiDrawElementsIndirect(mode, type, indirect, drawcount, stride);
+    }
+
+    void APIENTRY countDispatchCompute(GLuint x, GLuint y, GLuint z)
+    {
+        renderStats.add(STAT_DISPATCHES, 1);
+        realDispatchCompute(x, y, z);
+    }
+
+    void APIENTRY countUseProgram(GLuint program)
+    {
+        renderStats.add(STAT_PROGRAM_BINDS, 1);
+        realUseProgram(program);
+    }
+
+    void APIENTRY countBindTexture(GLenum target, GLuint texture)
+    {
+        renderStats.add(STAT_TEXTURE_BINDS, 1);
+        realBindTexture(target, texture);
+    }
+
+    void APIENTRY countBindVertexArray(GLuint vao)
+    {
+        renderStats.add(STAT_VAO_BINDS, 1);
+        realBindVertexArray(vao);
+    }
+
+    void APIENTRY countBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+    {
+        if (data)
+            renderStats.add(STAT_BUFFER_BYTES, (uint64_t)size);
+        realBufferData(target, size, data, usage);
+    }
+
+    void APIENTRY countBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+    {
+        renderStats.add(STAT_BUFFER_BYTES, (uint64_t)size);
+        realBufferSubData(target, offset, size, data);
+    }
+
+    void APIENTRY countTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                                  GLint border, GLenum format, GLenum type, const void* pixels)
+    {
+        if (pixels)
+            renderStats.add(STAT_TEXTURE_BYTES, (uint64_t)width * height * pixelBytes(format, type));
+        realTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    }
+
+    void APIENTRY countTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                                     GLenum format, GLenum type, const void* pixels)
+    {
+        renderStats.add(STAT_TEXTURE_BYTES, (uint64_t)width * height * pixelBytes(format, type));
+        realTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    }
+
+    // glUniform* 变体较多，用宏生成
+#define UNIFORM_WRAPPER(Name, Proc, Params, Args)           \
+    Proc real##Name = NULL;                                 \
+    void APIENTRY count##Name Params                        \
+    {                                                       \
+        renderStats.add(STAT_UNIFORM_UPLOADS, 1);           \
+        real##Name Args;                                    \
+    }
+
+    UNIFORM_WRAPPER(Uniform1f, PFNGLUNIFORM1FPROC, (GLint l, GLfloat v0), (l, v0))
+    UNIFORM_WRAPPER(Uniform2f, PFNGLUNIFORM2FPROC, (GLint l, GLfloat v0, GLfloat v1), (l, v0, v1))
+    UNIFORM_WRAPPER(Uniform3f, PFNGLUNIFORM3FPROC, (GLint l, GLfloat v0, GLfloat v1, GLfloat v2), (l, v0, v1, v2))
+    UNIFORM_WRAPPER(Uniform4f, PFNGLUNIFORM4FPROC, (GLint l, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (l, v0, v1, v2, v3))
+    UNIFORM_WRAPPER(Uniform1i, PFNGLUNIFORM1IPROC, (GLint l, GLint v0), (l, v0))
+    UNIFORM_WRAPPER(Uniform1ui, PFNGLUNIFORM1UIPROC, (GLint l, GLuint v0), (l, v0))
+    UNIFORM_WRAPPER(Uniform1fv, PFNGLUNIFORM1FVPROC, (GLint l, GLsizei n, const GLfloat* v), (l, n, v))
+    UNIFORM_WRAPPER(Uniform3fv, PFNGLUNIFORM3FVPROC, (GLint l, GLsizei n, const GLfloat* v), (l, n, v))
+    UNIFORM_WRAPPER(Uniform4fv, PFNGLUNIFORM4FVPROC, (GLint l, GLsizei n, const GLfloat* v), (l, n, v))
+    UNIFORM_WRAPPER(UniformMatrix3fv, PFNGLUNIFORMMATRIX3FVPROC, (GLint l, GLsizei n, GLboolean t, const GLfloat* v), (l, n, t, v))
+    UNIFORM_WRAPPER(UniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC, (GLint l, GLsizei n, GLboolean t, const GLfloat* v), (l, n, t, v))
+
+#undef UNIFORM_WRAPPER
+
+    // 入口存在时才替换（例如不支持计算着色器时 glDispatchCompute 为空）
+    template <typename Proc>
+    void hook(Proc& entry, Proc& real, Proc wrapper)
+    {
+        if (entry && entry != wrapper)
+        {
+            real = entry;
+            entry = wrapper;
+        }
+    }
+}
+
+RenderStats::RenderStats()
+    : hooked(false), frames(0), lastFrameEnd(0), frameMs(0.0f), maxFrameMs(0.0f), logCsv(false), logInterval(1)
+{
+    memset(&frame, 0, sizeof(frame));
+    memset(&last, 0, sizeof(last));
+    memset(&total, 0, sizeof(total));
+}
+
+RenderStats::~RenderStats()
+{
+    closeLog();
+}
+
+void RenderStats::install()
+{
+    if (hooked)
+        return;
+    hook(glad_glDrawArrays, realDrawArrays, countDrawArrays);
+    hook(glad_glDrawElements, realDrawElements, countDrawElements);
+    hook(glad_glDrawArraysInstanced, realDrawArraysInstanced, countDrawArraysInstanced);
+    hook(glad_glDrawElementsInstanced, realDrawElementsInstanced, countDrawElementsInstanced);
+    hook(glad_glMultiDrawArrays, realMultiDrawArrays, countMultiDrawArrays);
+    hook(glad_glMultiDrawElements, realMultiDrawElements, countMultiDrawElements);
+    hook(glDrawArraysIndirect, realDrawArraysIndirect, countDrawArraysIndirect);
+    hook(glMultiDrawElementsIndirect, realMultiDrawElementsIndirect, countMultiDrawElementsIndirect);
+    hook(glDispatchCompute, realDispatchCompute, countDispatchCompute);
+    hook(glad_glUseProgram, realUseProgram, countUseProgram);
+    hook(glad_glBindTexture, realBindTexture, countBindTexture);
+    hook(glad_glBindVertexArray, realBindVertexArray, countBindVertexArray);
+    hook(glad_glBufferData, realBufferData, countBufferData);
+    hook(glad_glBufferSubData, realBufferSubData, countBufferSubData);
+    hook(glad_glTexImage2D, realTexImage2D, countTexImage2D);
+    hook(glad_glTexSubImage2D, realTexSubImage2D, countTexSubImage2D);
+    hook(glad_glUniform1f, realUniform1f, countUniform1f);
+    hook(glad_glUniform2f, realUniform2f, countUniform2f);
+    hook(glad_glUniform3f, realUniform3f, countUniform3f);
+    hook(glad_glUniform4f, realUniform4f, countUniform4f);
+    hook(glad_glUniform1i, realUniform1i, countUniform1i);
+    hook(glad_glUniform1ui, realUniform1ui, countUniform1ui);
+    hook(glad_glUniform1fv, realUniform1fv, countUniform1fv);
+    hook(glad_glUniform3fv, realUniform3fv, countUniform3fv);
+    hook(glad_glUniform4fv, realUniform4fv, countUniform4fv);
+    hook(glad_glUniformMatrix3fv, realUniformMatrix3fv, countUniformMatrix3fv);
+    hook(glad_glUniformMatrix4fv, realUniformMatrix4fv, countUniformMatrix4fv);
+    hooked = true;
+    lastFrameEnd = nowNs();
+}
+
+void RenderStats::endFrame()
+{
+    uint64_t now = nowNs();
+    frameMs = (now - lastFrameEnd) * 1e-6f;
+    lastFrameEnd = now;
+    maxFrameMs = std::max(maxFrameMs, frameMs);
+
+    last = frame;
+    for (int i = 0; i < RENDER_COUNTER_COUNT; i++)
+        total.values[i] += frame.values[i];
+    memset(&frame, 0, sizeof(frame));
+    frames++;
+
+    if (log.is_open() && frames % logInterval == 0)
+    {
+        writeLogRecord();
+        maxFrameMs = 0.0f;
+    }
+}
+
+bool RenderStats::openLog(const char* path, int interval)
+{
+    closeLog();
+    std::string name = path;
+    logCsv = name.size() >= 4 && name.compare(name.size() - 4, 4, ".csv") == 0;
+    logInterval = std::max(interval, 1);
+    log.open(path, logCsv ? std::ios::trunc : std::ios::binary | std::ios::trunc);
+    if (!log.is_open())
+    {
+        std::cout << "ERROR::RENDER_STATS::CANNOT_OPEN_FILE: " << path << std::endl;
+        return false;
+    }
+
+    if (logCsv)
+    {
+        log << "frame,frame_ms,max_frame_ms";
+        for (const char* counterName : RENDER_COUNTER_NAMES)
+            log << ',' << counterName;
+        log << '\n';
+    }
+    else
+    {
+        const uint32_t version = 1;
+        const uint32_t counters = RENDER_COUNTER_COUNT;
+        log.write("SEMSTAT", 8);
+        log.write((const char*)&version, sizeof(version));
+        log.write((const char*)&counters, sizeof(counters));
+        for (const char* counterName : RENDER_COUNTER_NAMES)
+            log.write(counterName, strlen(counterName) + 1);
+    }
+    maxFrameMs = 0.0f;
+    return true;
+}
+
+void RenderStats::closeLog()
+{
+    if (log.is_open())
+        log.close();
+}
+
+void RenderStats::writeLogRecord()
+{
+    if (logCsv)
+    {
+        char timing[64];
+        snprintf(timing, sizeof(timing), "%llu,%.3f,%.3f", frames, frameMs, maxFrameMs);
+        log << timing;
+        for (uint64_t value : last.values)
+            log << ',' << value;
+        log << '\n';
+    }
+    else
+    {
+        uint64_t frame64 = frames;
+        log.write((const char*)&frame64, sizeof(frame64));
+        log.write((const char*)&frameMs, sizeof(frameMs));
+        log.write((const char*)&maxFrameMs, sizeof(maxFrameMs));
+        log.write((const char*)last.values, sizeof(last.values));
+    }
+}
+
+float RenderStats::drawHud(HudOverlay& hud, float x, float y) const
+{
+    const glm::vec4 TEXT(0.9f, 0.9f, 0.9f, 1.0f);
+    const float line = hud.lineHeight();
+    const int LINES = 8;
+    hud.rect(x - 4.0f, y - 4.0f, hud.charWidth() * 34 + 8.0f, line * LINES + 8.0f, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+
+    char text[64];
+    snprintf(text, sizeof(text), "DRAW CALLS %6llu  INDIRECT %6llu",
+             (unsigned long long)last[STAT_DRAW_CALLS], (unsigned long long)last[STAT_INDIRECT_COMMANDS]);
+    hud.text(x, y, text, TEXT);
+    snprintf(text, sizeof(text), "TRIANGLES  %10llu", (unsigned long long)last[STAT_TRIANGLES]);
+    hud.text(x, y + line, text, TEXT);
+    snprintf(text, sizeof(text), "PROGRAMS   %6llu  DISPATCH %6llu",
+             (unsigned long long)last[STAT_PROGRAM_BINDS], (unsigned long long)last[STAT_DISPATCHES]);
+    hud.text(x, y + line * 2, text, TEXT);
+    snprintf(text, sizeof(text), "TEXTURES   %6llu  VAOS     %6llu",
+             (unsigned long long)last[STAT_TEXTURE_BINDS], (unsigned long long)last[STAT_VAO_BINDS]);
+    hud.text(x, y + line * 3, text, TEXT);
+    snprintf(text, sizeof(text), "UNIFORMS   %6llu", (unsigned long long)last[STAT_UNIFORM_UPLOADS]);
+    hud.text(x, y + line * 4, text, TEXT);
+    snprintf(text, sizeof(text), "BUFFER UP  %8.1f KB", last[STAT_BUFFER_BYTES] / 1024.0);
+    hud.text(x, y + line * 5, text, TEXT);
+    snprintf(text, sizeof(text), "TEXTURE UP %8.1f KB", last[STAT_TEXTURE_BYTES] / 1024.0);
+    hud.text(x, y + line * 6, text, TEXT);
+    snprintf(text, sizeof(text), "FRAME      %8.2f MS", frameMs);
+    hud.text(x, y + line * 7, text, TEXT);
+    return y + line * LINES + 12.0f;
+}
@@ -0,0 +1,93 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+class HudOverlay;
+
+// 每帧渲染统计：绘制调用、三角形、状态绑定、uniform 调用和数据上传量
+//
+// install 把 glad（以及 gl_ext 中运行时加载）的函数指针换成先计数再转发的包装，
+// 所有模块（包括 common/ 中的代码）不需要改动就会被统计；不调用 install 时没有任何开销。
+// 间接绘制的图元数由 GPU 决定，只计绘制调用和间接命令数，不计入三角形。
+//
+// 日志文件每 interval 帧写一行（该帧的计数、帧时间和这段时间内的最长帧时间），
+// 扩展名为 .csv 时写文本，否则写二进制：
+//   文件头 : "SEMSTAT\0" | version(u32) | counterCount(u32) | 各计数名（以 \0 结尾）
+//   记录   : frame(u64) | frameMs(f32) | maxFrameMs(f32) | counters(u64 * counterCount)
+
+enum RenderCounter
+{
+    STAT_DRAW_CALLS,
+    STAT_TRIANGLES,
+    STAT_INDIRECT_COMMANDS,     // 间接绘制提交的命令数
+    STAT_DISPATCHES,            // 计算着色器调度
+    STAT_PROGRAM_BINDS,
+    STAT_TEXTURE_BINDS,
+    STAT_VAO_BINDS,
+    STAT_UNIFORM_UPLOADS,
+    STAT_BUFFER_BYTES,          // glBufferData / glBufferSubData 上传的字节数（只分配不上传的不计）
+    STAT_TEXTURE_BYTES,         // glTexImage2D / glTexSubImage2D 上传的字节数
+    RENDER_COUNTER_COUNT
+};
+
+// 日志和叠加层中的名字
+extern const char* const RENDER_COUNTER_NAMES[RENDER_COUNTER_COUNT];
+
+struct RenderCounters
+{
+    uint64_t values[RENDER_COUNTER_COUNT];
+
+    uint64_t operator[](RenderCounter counter) const { return values[counter]; }
+};
+
+class RenderStats
+{
+public:
+    RenderStats();
+    ~RenderStats();
+
+    // 在 gladLoadGLLoader 与 loadGLExtensions 之后调用一次
+    void install();
+    bool installed() const { return hooked; }
+
+    void add(RenderCounter counter, uint64_t amount) { frame.values[counter] += amount; }
+
+    // 每帧交换缓冲之后调用：保存本帧计数并清零，按间隔写日志
+    void endFrame();
+
+    // 最近一个完整帧的计数
+    const RenderCounters& lastFrame() const { return last; }
+    // 自 install 以来的累计
+    const RenderCounters& totals() const { return total; }
+    unsigned long long frameCount() const { return frames; }
+    float lastFrameMs() const { return frameMs; }
+
+    bool openLog(const char* path, int interval);
+    void closeLog();
+
+    // 左上角 (x, y) 开始绘制上一帧的计数，返回下方空白处的 y
+    float drawHud(HudOverlay& hud, float x, float y) const;
+
+private:
+    void writeLogRecord();
+
+    bool hooked;
+    RenderCounters frame;
+    RenderCounters last;
+    RenderCounters total;
+    unsigned long long frames;
+    uint64_t lastFrameEnd;      // 纳秒
+    float frameMs;
+    float maxFrameMs;           // 上一条日志之后的最长帧时间
+
+    std::ofstream log;
+    bool logCsv;
+    int logInterval;
+};
+
+extern RenderStats renderStats;
+
+#endif // RENDER_STATS_H
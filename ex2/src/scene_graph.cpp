@@ -0,0 +1,103 @@
+#include "scene_graph.h"
+
+#include "profiler.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cassert>
+
+SceneGraph::SceneGraph()
+    : firstDirty(0), updatedCount(0)
+{
+}
+
+int SceneGraph::addNode(int parent, const glm::vec3& translation, float rotationAngle,
+                        const glm::vec3& rotationAxis, const glm::vec3& scale)
+{
+    assert(parent < (int)parents.size());
+
+    LocalTransform local;
+    local.translation = translation;
+    local.rotationAngle = rotationAngle;
+    local.rotationAxis = rotationAxis;
+    local.scale = scale;
+
+    int index = (int)parents.size();
+    parents.push_back(parent);
+    locals.push_back(local);
+    worlds.push_back(glm::mat4(1.0f));
+    localDirty.push_back(0);
+    worldChanged.push_back(0);
+    markDirty(index);
+    return index;
+}
+
+void SceneGraph::setTranslation(int node, const glm::vec3& translation)
+{
+    if (locals[node].translation == translation)
+        return;
+    locals[node].translation = translation;
+    markDirty(node);
+}
+
+void SceneGraph::setRotation(int node, float angle, const glm::vec3& axis)
+{
+    if (locals[node].rotationAngle == angle && locals[node].rotationAxis == axis)
+        return;
+    locals[node].rotationAngle = angle;
+    locals[node].rotationAxis = axis;
+    markDirty(node);
+}
+
+void SceneGraph::setScale(int node, const glm::vec3& scale)
+{
+    if (locals[node].scale == scale)
+        return;
+    locals[node].scale = scale;
+    markDirty(node);
+}
+
+void SceneGraph::markDirty(int node)
+{
+    if (!localDirty[node] && (size_t)node < firstDirty)
+        firstDirty = node;
+    localDirty[node] = 1;
+}
+
+void SceneGraph::update()
+{
+    PROFILE_CPU("scene graph");
+    updatedCount = 0;
+    size_t count = parents.size();
+    if (firstDirty >= count)
+        return;
+
+    // 父节点总在子节点之前，一次线性遍历即可传播变化
+    for (size_t i = firstDirty; i < count; i++)
+    {
+        int p = parents[i];
+        // firstDirty 之前的父节点本次不会改变
+        bool parentChanged = p >= (int)firstDirty && worldChanged[p];
+        if (!localDirty[i] && !parentChanged)
+        {
+            worldChanged[i] = 0;
+            continue;
+        }
+
+        glm::mat4 local = compose(locals[i]);
+        worlds[i] = p >= 0 ? worlds[p] * local : local;
+        localDirty[i] = 0;
+        worldChanged[i] = 1;
+        updatedCount++;
+    }
+
+    firstDirty = count;
+}
+
+glm::mat4 SceneGraph::compose(const LocalTransform& local)
+{
+    glm::mat4 m = glm::translate(glm::mat4(1.0f), local.translation);
+    if (local.rotationAngle != 0.0f)
+        m = glm::rotate(m, local.rotationAngle, local.rotationAxis);
+    return glm::scale(m, local.scale);
+}
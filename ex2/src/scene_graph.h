@@ -0,0 +1,63 @@
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// 扁平层级变换：节点按父节点在前的顺序连续存放
+//
+// 局部变换带脏标记，update() 只做一次线性遍历，
+// 仅重新计算自身或祖先发生变化的节点的世界矩阵。
+// 静态节点（天空盒、星表、标签等）不被修改时每帧没有任何计算。
+// 层级深度不限，如 行星 -> 卫星 -> 空间站。
+class SceneGraph
+{
+public:
+    SceneGraph();
+
+    // parent 为 -1 表示根节点；父节点必须已存在，保证父节点索引小于子节点
+    int addNode(int parent,
+                const glm::vec3& translation = glm::vec3(0.0f),
+                float rotationAngle = 0.0f,
+                const glm::vec3& rotationAxis = glm::vec3(0.0f, 1.0f, 0.0f),
+                const glm::vec3& scale = glm::vec3(1.0f));
+
+    // 修改局部变换；值未变化时不会标脏
+    void setTranslation(int node, const glm::vec3& translation);
+    void setRotation(int node, float angle, const glm::vec3& axis);
+    void setScale(int node, const glm::vec3& scale);
+
+    // 重新计算所有脏节点及其后代的世界矩阵
+    void update();
+
+    size_t nodeCount() const { return parents.size(); }
+    int parent(int node) const { return parents[node]; }
+    const glm::mat4& world(int node) const { return worlds[node]; }
+    glm::vec3 worldPosition(int node) const { return glm::vec3(worlds[node][3]); }
+
+    // 上一次 update() 实际重新计算的节点数
+    size_t lastUpdatedCount() const { return updatedCount; }
+
+private:
+    struct LocalTransform
+    {
+        glm::vec3 translation;
+        float rotationAngle;
+        glm::vec3 rotationAxis;
+        glm::vec3 scale;
+    };
+
+    void markDirty(int node);
+    static glm::mat4 compose(const LocalTransform& local);
+
+    std::vector<int> parents;
+    std::vector<LocalTransform> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<unsigned char> localDirty;
+    std::vector<unsigned char> worldChanged;    // 本次 update 中世界矩阵是否改变
+
+    size_t firstDirty;      // 最小的脏节点索引，之前的节点无需遍历
+    size_t updatedCount;
+};
+
+#endif // SCENE_GRAPH_H
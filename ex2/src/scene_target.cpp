@@ -0,0 +1,278 @@
+#include "scene_target.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+#include "gl_ext.h"
+#include "hud_overlay.h"
+
+namespace
+{
+    const float SCALE_HEADROOM = 0.85f;         // GPU 时间低于预算的这个比例才提高分辨率
+    const float MAX_SCALE_RISE = 0.03f;         // 每次调整最多提高（降低时一次降到位）
+    const int ADJUST_COOLDOWN = 4;              // 调整后跳过的测量帧数（结果有 2~3 帧延迟）
+    const float GPU_SMOOTHING = 0.2f;
+}
+
+SceneTarget::SceneTarget()
+    : reversed(false), framebuffer(0), colorBuffer(0), depthBuffer(0), bufferWidth(0), bufferHeight(0),
+      windowWidth(0), windowHeight(0), dynamic(false), budget(0.0f), minimumScale(1.0f), scale(1.0f),
+      renderW(0), renderH(0), smoothedGpuMs(0.0f), cooldown(0), timerIndex(0)
+{
+    for (int i = 0; i < TIMER_FRAMES; i++)
+    {
+        timerQueries[i] = 0;
+        timerPending[i] = false;
+    }
+}
+
+SceneTarget::~SceneTarget()
+{
+    release();
+}
+
+void SceneTarget::init(bool allowReversedZ, int width, int height)
+{
+    release();
+    windowWidth = renderW = width;
+    windowHeight = renderH = height;
+
+    reversed = allowReversedZ && glCaps.clipControl;
+    if (reversed)
+    {
+        glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+        glDepthFunc(GL_GREATER);
+        // 帧缓冲创建失败时仍使用反向Z，只是深度精度退回窗口的定点深度缓冲
+        if (!createFramebuffer(width, height))
+            std::cout << "ERROR::SCENE_TARGET::FRAMEBUFFER_INCOMPLETE: rendering to the window depth buffer" << std::endl;
+    }
+    else
+    {
+        glDepthFunc(GL_LESS);
+    }
+}
+
+void SceneTarget::enableDynamicResolution(float budgetMs, float minScale, bool measureGpu)
+{
+    if (!framebuffer && !createFramebuffer(windowWidth, windowHeight))
+    {
+        std::cout << "ERROR::SCENE_TARGET::FRAMEBUFFER_INCOMPLETE: dynamic resolution disabled" << std::endl;
+        return;
+    }
+    dynamic = true;
+    budget = budgetMs;
+    minimumScale = std::min(std::max(minScale, 0.1f), 1.0f);
+    scale = 1.0f;
+    smoothedGpuMs = 0.0f;
+    cooldown = 0;
+    if (measureGpu && !timerQueries[0])
+        glGenQueries(TIMER_FRAMES, timerQueries);
+    for (int i = 0; i < TIMER_FRAMES; i++)
+        timerPending[i] = false;
+    timerIndex = 0;
+}
+
+void SceneTarget::release()
+{
+    releaseFramebuffer();
+    if (timerQueries[0])
+        glDeleteQueries(TIMER_FRAMES, timerQueries);
+    for (int i = 0; i < TIMER_FRAMES; i++)
+    {
+        timerQueries[i] = 0;
+        timerPending[i] = false;
+    }
+    dynamic = false;
+    scale = 1.0f;
+    if (reversed)
+    {
+        glClipControl(GL_LOWER_LEFT, GL_NEGATIVE_ONE_TO_ONE);
+        glDepthFunc(GL_LESS);
+        reversed = false;
+    }
+}
+
+glm::mat4 SceneTarget::projection(float fovy, float aspect, float nearPlane) const
+{
+    if (!reversed)
+        return glm::infinitePerspective(fovy, aspect, nearPlane);
+
+    // 裁剪空间 z = nearPlane，w = -z_view，深度 = nearPlane / 距离：近平面为 1，无限远为 0
+    float f = 1.0f / std::tan(fovy * 0.5f);
+    glm::mat4 m(0.0f);
+    m[0][0] = f / aspect;
+    m[1][1] = f;
+    m[2][3] = -1.0f;
+    m[3][2] = nearPlane;
+    return m;
+}
+
+void SceneTarget::begin(int width, int height, const glm::vec4& clearColor)
+{
+    // 最小化时帧缓冲大小为 0，保留原来的缓冲和尺寸
+    if (width > 0 && height > 0)
+    {
+        windowWidth = width;
+        windowHeight = height;
+        if (framebuffer && (width != bufferWidth || height != bufferHeight))
+        {
+            if (!createFramebuffer(width, height))
+            {
+                std::cout << "ERROR::SCENE_TARGET::FRAMEBUFFER_INCOMPLETE: rendering to the window depth buffer" << std::endl;
+                dynamic = false;
+                scale = 1.0f;
+            }
+        }
+    }
+
+    if (dynamic && timerQueries[0])
+    {
+        readGpuTime();
+        glBeginQuery(GL_TIME_ELAPSED, timerQueries[timerIndex]);
+    }
+
+    renderW = std::max(1, (int)(windowWidth * scale + 0.5f));
+    renderH = std::max(1, (int)(windowHeight * scale + 0.5f));
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, renderW, renderH);
+    glClearColor(clearColor.x, clearColor.y, clearColor.z, clearColor.w);
+    glClearDepth(reversed ? 0.0 : 1.0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void SceneTarget::resolve()
+{
+    if (!framebuffer)
+        return;
+
+    // 缩小渲染时双线性放大，原尺寸时逐像素复制
+    bool scaled = renderW != bufferWidth || renderH != bufferHeight;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, renderW, renderH, 0, 0, bufferWidth, bufferHeight,
+                      GL_COLOR_BUFFER_BIT, scaled ? GL_LINEAR : GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+
+    if (dynamic && timerQueries[0])
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        timerPending[timerIndex] = true;
+        timerIndex = (timerIndex + 1) % TIMER_FRAMES;
+    }
+}
+
+void SceneTarget::readGpuTime()
+{
+    // 即将复用的这一组是 TIMER_FRAMES 帧之前发出的；还没就绪就丢弃，不等待GPU
+    if (!timerPending[timerIndex])
+        return;
+    timerPending[timerIndex] = false;
+
+    GLint available = 0;
+    glGetQueryObjectiv(timerQueries[timerIndex], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return;
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(timerQueries[timerIndex], GL_QUERY_RESULT, &elapsed);
+    adjustScale((float)(elapsed / 1e6));
+}
+
+void SceneTarget::reportGpuTime(float frameGpuMs)
+{
+    if (dynamic)
+        adjustScale(frameGpuMs);
+}
+
+void SceneTarget::adjustScale(float frameGpuMs)
+{
+    smoothedGpuMs = smoothedGpuMs > 0.0f ? smoothedGpuMs + (frameGpuMs - smoothedGpuMs) * GPU_SMOOTHING : frameGpuMs;
+    if (cooldown > 0)
+    {
+        cooldown--;
+        return;
+    }
+
+    // 填充开销与像素数（比例的平方）成正比
+    float desired = scale * std::sqrt(budget / std::max(smoothedGpuMs, 0.01f));
+    desired = std::min(std::max(desired, minimumScale), 1.0f);
+    float next = scale;
+    if (smoothedGpuMs > budget)
+        next = desired;
+    else if (smoothedGpuMs < budget * SCALE_HEADROOM)
+        next = std::min(desired, scale + MAX_SCALE_RISE);
+
+    if (std::fabs(next - scale) > 0.005f)
+    {
+        scale = next;
+        cooldown = ADJUST_COOLDOWN;
+    }
+}
+
+float SceneTarget::drawHud(HudOverlay& hud, float x, float y) const
+{
+    if (!dynamic)
+        return y;
+
+    const glm::vec4 TEXT(0.9f, 0.9f, 0.9f, 1.0f);
+    const float line = hud.lineHeight();
+    const int LINES = 2;
+    hud.rect(x - 4.0f, y - 4.0f, hud.charWidth() * 34 + 8.0f, line * LINES + 8.0f, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+
+    char text[64];
+    snprintf(text, sizeof(text), "RES SCALE %4.2f  %5dX%-5d", scale, renderW, renderH);
+    hud.text(x, y, text, TEXT);
+    snprintf(text, sizeof(text), "SCENE GPU %6.2f MS  BUDGET %5.1f", smoothedGpuMs, budget);
+    hud.text(x, y + line, text, TEXT);
+    return y + line * LINES + 12.0f;
+}
+
+bool SceneTarget::createFramebuffer(int width, int height)
+{
+    releaseFramebuffer();
+
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete)
+    {
+        releaseFramebuffer();
+        return false;
+    }
+    bufferWidth = width;
+    bufferHeight = height;
+    return true;
+}
+
+void SceneTarget::releaseFramebuffer()
+{
+    if (framebuffer)
+        glDeleteFramebuffers(1, &framebuffer);
+    if (colorBuffer)
+        glDeleteRenderbuffers(1, &colorBuffer);
+    if (depthBuffer)
+        glDeleteRenderbuffers(1, &depthBuffer);
+    framebuffer = 0;
+    colorBuffer = 0;
+    depthBuffer = 0;
+    bufferWidth = 0;
+    bufferHeight = 0;
+}
@@ -0,0 +1,95 @@
+#ifndef SCENE_TARGET_H
+#define SCENE_TARGET_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+class HudOverlay;
+
+// 场景的渲染目标与深度约定：反向Z + 浮点深度 + 无限远平面
+//
+// 支持 glClipControl（GL 4.5 / ARB_clip_control）时，裁剪空间深度改为 [0, 1]，
+// 投影把近平面映射到 1、无限远映射到 0，并渲染到带 32 位浮点深度的离屏帧缓冲：
+// 浮点数在 0 附近的精度与 1/z 的衰减互相抵消，整个深度范围内的相对精度几乎不变，
+// 从近平面到太阳系外缘只需要一遍深度，不会被远平面裁掉也不会出现深度冲突。
+// 场景画完后用 glBlitFramebuffer 复制到窗口，叠加层直接画在窗口上。
+//
+// 不支持时（GL 3.3）直接画到窗口的默认深度缓冲，使用传统 [-1, 1] 深度的无限远透视，
+// 远处天体不会被裁掉，但远距离的深度精度与原来相同。
+//
+// 动态分辨率：场景只画在离屏缓冲左下角按比例缩小的区域，复制到窗口时双线性放大，叠加层仍是原生分辨率。
+// 每帧用一个 GL_TIME_ELAPSED 查询包住场景开始到复制完成的所有命令，只计 GPU 实际执行的时间，
+// 不含帧与帧之间 GPU 等待提交的空闲；几帧之后读取已就绪的结果、从不等待。
+// 分析器的 GPU 段也用 GL_TIME_ELAPSED，查询不能嵌套，因此启用分析器时不发出自己的查询，
+// 改由调用者通过 reportGpuTime 提供分析器测得的场景各遍 GPU 时间。超出预算时按面积比例立即降低比例，
+// 低于预算的 85% 时每次小幅提高，每次调整后等几帧结果再判断，避免来回振荡。
+class SceneTarget
+{
+public:
+    SceneTarget();
+    ~SceneTarget();
+
+    // 在 loadGLExtensions 之后、提交着色器之前调用（替身着色器需要知道深度约定）
+    // allowReversedZ 为 false 时总是使用传统深度
+    void init(bool allowReversedZ, int width, int height);
+    void release();
+
+    bool reversedZ() const { return reversed; }
+
+    // 在 init 之后调用；需要离屏帧缓冲，传统深度模式下也会创建
+    // measureGpu 为 false 时不发出计时查询，GPU 时间全部由 reportGpuTime 提供
+    void enableDynamicResolution(float budgetMs, float minScale, bool measureGpu);
+    // 提供一帧场景的 GPU 时间（毫秒），结果可以晚几帧
+    void reportGpuTime(float frameGpuMs);
+    bool dynamicResolution() const { return dynamic; }
+    float resolutionScale() const { return scale; }
+    // 场景实际渲染的尺寸（像素），投影直径等按它计算
+    int renderWidth() const { return renderW; }
+    int renderHeight() const { return renderH; }
+    // 最近的场景 GPU 时间（毫秒，平滑后）
+    float gpuMs() const { return smoothedGpuMs; }
+
+    // 无限远平面的透视投影，深度约定与当前模式一致
+    glm::mat4 projection(float fovy, float aspect, float nearPlane) const;
+
+    // 每帧开始时调用：绑定场景帧缓冲（窗口大小变化时重建）、设置缩放后的视口并清除颜色与深度
+    void begin(int width, int height, const glm::vec4& clearColor);
+    // 场景绘制完后调用：把颜色复制（放大）到窗口，绑定默认帧缓冲并恢复窗口大小的视口
+    void resolve();
+
+    // 左上角 (x, y) 开始绘制分辨率比例与 GPU 时间，返回下方空白处的 y
+    float drawHud(HudOverlay& hud, float x, float y) const;
+
+private:
+    static const int TIMER_FRAMES = 3;
+
+    bool createFramebuffer(int width, int height);
+    void releaseFramebuffer();
+    void readGpuTime();
+    void adjustScale(float frameGpuMs);
+
+    bool reversed;
+    unsigned int framebuffer;   // 0 表示直接画到窗口
+    unsigned int colorBuffer;
+    unsigned int depthBuffer;
+    int bufferWidth;
+    int bufferHeight;
+    int windowWidth;
+    int windowHeight;
+
+    bool dynamic;
+    float budget;               // 毫秒
+    float minimumScale;
+    float scale;
+    int renderW;
+    int renderH;
+    float smoothedGpuMs;
+    int cooldown;               // 距离下次允许调整还需要的测量帧数
+
+    // 每帧一个 GL_TIME_ELAPSED 查询，轮换使用；measureGpu 为 false 时不创建
+    unsigned int timerQueries[TIMER_FRAMES];
+    bool timerPending[TIMER_FRAMES];
+    int timerIndex;
+};
+
+#endif // SCENE_TARGET_H
@@ -0,0 +1,129 @@
+#include "simulation.h"
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    const double TWO_PI = 6.28318530717958647692;
+    // 单帧最大真实时间，窗口拖动等造成的长帧不再整体补偿
+    const double MAX_FRAME_TIME = 0.25;
+    // 总工作量低于该值时不值得分发到线程池
+    const long long PARALLEL_THRESHOLD = 4096;
+}
+
+Simulation::Simulation(WorkerPool& pool)
+    : budgetSeconds(0.008), stepsPerOrbit(64), pool(pool),
+      minPeriod(0.0), simTime(0.0), secondsPerSubstep(1e-7),
+      lastEffectiveWarp(1.0), lastSubsteps(0)
+{
+}
+
+int Simulation::addBody(const BodyDesc& desc)
+{
+    BodyState state;
+    state.spinAngle = 0.0;
+    state.gm = 0.0;
+    state.relPos = glm::dvec3(0.0);
+    state.relVel = glm::dvec3(0.0);
+
+    if (desc.parent >= 0 && desc.orbitRadius > 0.0f && desc.orbitSpeed != 0.0f)
+    {
+        double r = desc.orbitRadius;
+        double w = desc.orbitSpeed;
+        double tilt = desc.orbitTilt;
+        // 与原先解析式一致：角度为0时位于 +X，沿倾斜轨道面运动
+        state.relPos = glm::dvec3(r, 0.0, 0.0);
+        state.relVel = glm::dvec3(0.0, std::sin(tilt), std::cos(tilt)) * (r * w);
+        state.gm = w * w * r * r * r;
+
+        double period = TWO_PI / std::fabs(w);
+        if (minPeriod == 0.0 || period < minPeriod)
+            minPeriod = period;
+    }
+
+    descs.push_back(desc);
+    states.push_back(state);
+    return (int)descs.size() - 1;
+}
+
+void Simulation::advance(double realDt, double warp)
+{
+    PROFILE_CPU("simulation");
+    realDt = std::min(std::max(realDt, 0.0), MAX_FRAME_TIME);
+    double simDt = realDt * warp;
+    if (simDt <= 0.0 || descs.empty())
+    {
+        lastSubsteps = 0;
+        lastEffectiveWarp = warp;
+        return;
+    }
+
+    // 按最快轨道周期确定子步长
+    double maxStep = minPeriod > 0.0 ? minPeriod / stepsPerOrbit : simDt;
+    long long wanted = (long long)std::ceil(simDt / maxStep);
+    long long affordable = std::max(1LL, (long long)(budgetSeconds / secondsPerSubstep));
+
+    long long steps = wanted;
+    if (wanted > affordable)
+    {
+        // 超出预算：保持步长精度，缩短本帧推进的模拟时间
+        steps = affordable;
+        simDt = steps * maxStep;
+    }
+    double dt = simDt / steps;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (steps * (long long)descs.size() < PARALLEL_THRESHOLD)
+    {
+        for (size_t i = 0; i < descs.size(); i++)
+            integrate(i, steps, dt);
+    }
+    else
+    {
+        // 各天体相对父天体的运动互相独立，可按天体并行推进全部子步
+        pool.parallelFor(descs.size(), [&](size_t begin, size_t end) {
+            PROFILE_CPU("integrate");
+            for (size_t i = begin; i < end; i++)
+                integrate(i, steps, dt);
+        });
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double measured = std::max(elapsed / steps, 1e-10);
+    secondsPerSubstep = secondsPerSubstep * 0.8 + measured * 0.2;
+
+    simTime += simDt;
+    lastSubsteps = steps;
+    lastEffectiveWarp = simDt / std::max(realDt, 1e-9);
+}
+
+void Simulation::integrate(size_t index, long long steps, double dt)
+{
+    const BodyDesc& d = descs[index];
+    BodyState& s = states[index];
+
+    s.spinAngle = std::fmod(s.spinAngle + d.spinSpeed * dt * (double)steps, TWO_PI);
+    if (s.gm == 0.0)
+        return;
+
+    // 速度Verlet（辛积分），长时间积分轨道能量不会漂移
+    glm::dvec3 pos = s.relPos;
+    glm::dvec3 vel = s.relVel;
+    double r = glm::length(pos);
+    glm::dvec3 acc = pos * (-s.gm / (r * r * r));
+    for (long long i = 0; i < steps; i++)
+    {
+        vel += acc * (0.5 * dt);
+        pos += vel * dt;
+        r = glm::length(pos);
+        acc = pos * (-s.gm / (r * r * r));
+        vel += acc * (0.5 * dt);
+    }
+    s.relPos = pos;
+    s.relVel = vel;
+}
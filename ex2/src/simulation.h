@@ -0,0 +1,73 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "worker_pool.h"
+
+// 天体轨道参数
+struct BodyDesc
+{
+    const char* name;
+    int parent;             // 父天体索引，-1 表示固定在原点；必须先于子天体加入
+    float orbitRadius;      // 相对父天体的轨道半径
+    float orbitSpeed;       // 公转角速度（弧度/秒）
+    float orbitTilt;        // 轨道倾角（弧度，绕X轴倾斜）
+    float spinSpeed;        // 自转角速度（弧度/秒）
+    float radius;           // 天体半径
+};
+
+// 天体运动状态（双精度积分，长时间高倍率加速也不会累积明显误差）
+struct BodyState
+{
+    glm::dvec3 relPos;      // 相对父天体的位置
+    glm::dvec3 relVel;      // 相对父天体的速度
+    double gm;              // 父天体引力参数 GM = ω²r³，保证初始为圆轨道
+    double spinAngle;       // 自转角度
+};
+
+// 轨道模拟：每个天体绕父天体做二体运动，速度Verlet积分
+//
+// 时间加速后每帧需要推进的模拟时间可能远大于最快轨道周期，
+// 因此按最快周期自适应地细分子步，子步按天体分配给线程池并行计算；
+// 若子步耗时超过每帧预算，则降低本帧实际加速倍率而不是卡住界面。
+class Simulation
+{
+public:
+    explicit Simulation(WorkerPool& pool);
+
+    // 返回新天体索引
+    int addBody(const BodyDesc& desc);
+
+    // 推进真实时间 realDt（秒），warp 为期望的时间加速倍率
+    void advance(double realDt, double warp);
+
+    size_t bodyCount() const { return descs.size(); }
+    const BodyDesc& desc(int index) const { return descs[index]; }
+    const BodyState& state(int index) const { return states[index]; }
+
+    double time() const { return simTime; }
+    double effectiveWarp() const { return lastEffectiveWarp; }
+    long long substeps() const { return lastSubsteps; }
+
+    // 每帧模拟耗时预算（秒）
+    double budgetSeconds;
+    // 最快轨道每圈至少积分的步数
+    int stepsPerOrbit;
+
+private:
+    void integrate(size_t index, long long steps, double dt);
+
+    WorkerPool& pool;
+    std::vector<BodyDesc> descs;
+    std::vector<BodyState> states;
+
+    double minPeriod;
+    double simTime;
+    double secondsPerSubstep;   // 单个子步（全部天体）的实测耗时，指数平均
+    double lastEffectiveWarp;
+    long long lastSubsteps;
+};
+
+#endif // SIMULATION_H
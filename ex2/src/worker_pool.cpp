@@ -0,0 +1,154 @@
+#include "worker_pool.h"
+
+#include "profiler.h"
+
+WorkerPool::WorkerPool(unsigned int threadCount)
+    : job(nullptr), jobContext(nullptr), jobCount(0), generation(0), pending(0), stopping(false)
+{
+    if (threadCount == 0)
+    {
+        unsigned int hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 0;
+    }
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        threads.emplace_back(&WorkerPool::workerLoop, this, i + 1);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread& t : threads)
+        t.join();
+}
+
+void WorkerPool::run(size_t count, RangeFunction fn, const void* context)
+{
+    if (count == 0)
+        return;
+
+    // 没有工作线程或任务太少时直接在当前线程执行
+    if (threads.empty() || count == 1)
+    {
+        fn(context, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = fn;
+        jobContext = context;
+        jobCount = count;
+        pending = (unsigned int)threads.size();
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    // 调用线程负责第 0 段
+    size_t parts = size();
+    size_t end = count / parts;
+    if (end > 0)
+        fn(context, 0, end);
+
+    PROFILE_CPU("pool wait");
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return pending == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::workerLoop(unsigned int index)
+{
+    PROFILE_THREAD_NAME("worker");
+    unsigned long long seen = 0;
+    for (;;)
+    {
+        RangeFunction fn;
+        const void* context;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            fn = job;
+            context = jobContext;
+            count = jobCount;
+        }
+
+        size_t parts = size();
+        size_t begin = count * index / parts;
+        size_t end = count * (index + 1) / parts;
+        if (begin < end)
+            fn(context, begin, end);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+        }
+        doneCondition.notify_one();
+    }
+}
+
+BackgroundWorker::BackgroundWorker()
+    : hasJob(false), busy(false), stopping(false)
+{
+    thread = std::thread(&BackgroundWorker::loop, this);
+}
+
+BackgroundWorker::~BackgroundWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    thread.join();
+}
+
+void BackgroundWorker::start(const std::function<void()>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = task;
+        hasJob = true;
+        busy = true;
+    }
+    condition.notify_all();
+}
+
+void BackgroundWorker::wait()
+{
+    PROFILE_CPU("background wait");
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return !busy; });
+}
+
+void BackgroundWorker::loop()
+{
+    PROFILE_THREAD_NAME("background");
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return stopping || hasJob; });
+            if (stopping)
+                return;
+            task.swap(job);
+            hasJob = false;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy = false;
+        }
+        condition.notify_all();
+    }
+}
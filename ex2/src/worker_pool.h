@@ -0,0 +1,85 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 简单的工作线程池：常驻线程，按区间把任务切分给各线程并行执行
+class WorkerPool
+{
+public:
+    // threadCount 为 0 时使用 (硬件线程数 - 1) 个工作线程，调用线程本身也参与计算
+    explicit WorkerPool(unsigned int threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // 参与计算的线程总数（含调用线程）
+    unsigned int size() const { return (unsigned int)threads.size() + 1; }
+
+    // 把 [0, count) 均分成 size() 段并行执行 fn(begin, end)，返回时全部完成。
+    // fn 只按引用传给工作线程，不会像 std::function 那样复制捕获的变量，不产生堆分配
+    template <typename Fn>
+    void parallelFor(size_t count, const Fn& fn)
+    {
+        run(count, &invokeRange<Fn>, &fn);
+    }
+
+private:
+    typedef void (*RangeFunction)(const void* context, size_t begin, size_t end);
+
+    template <typename Fn>
+    static void invokeRange(const void* context, size_t begin, size_t end)
+    {
+        (*static_cast<const Fn*>(context))(begin, end);
+    }
+
+    void run(size_t count, RangeFunction fn, const void* context);
+    void workerLoop(unsigned int index);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    RangeFunction job;
+    const void* jobContext;
+    size_t jobCount;
+    unsigned long long generation;
+    unsigned int pending;
+    bool stopping;
+};
+
+// 单个常驻后台线程：在主线程做其他工作（如模拟）的同时执行一个任务
+class BackgroundWorker
+{
+public:
+    BackgroundWorker();
+    ~BackgroundWorker();
+
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+    // 开始执行任务；上一个任务必须已经 wait() 过
+    void start(const std::function<void()>& task);
+    // 等待当前任务完成（没有任务时立即返回）
+    void wait();
+
+private:
+    void loop();
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::function<void()> job;
+    bool hasJob;
+    bool busy;
+    bool stopping;
+};
+
+#endif // WORKER_POOL_H
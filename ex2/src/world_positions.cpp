@@ -0,0 +1,57 @@
+#include "world_positions.h"
+
+#include "profiler.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define WORLD_SIMD_WIDTH 4
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WORLD_SIMD_WIDTH 2
+#else
+#define WORLD_SIMD_WIDTH 1
+#endif
+
+void WorldPositions::resize(size_t n)
+{
+    count = n;
+    x.resize(n, 0.0);
+    y.resize(n, 0.0);
+    z.resize(n, 0.0);
+}
+
+void WorldPositions::toCameraRelative(const glm::dvec3& camera, float* outX, float* outY, float* outZ) const
+{
+    PROFILE_CPU("camera relative");
+    size_t i = 0;
+
+#if WORLD_SIMD_WIDTH == 4
+    const __m256d cx = _mm256_set1_pd(camera.x);
+    const __m256d cy = _mm256_set1_pd(camera.y);
+    const __m256d cz = _mm256_set1_pd(camera.z);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(outX + i, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(&x[i]), cx)));
+        _mm_storeu_ps(outY + i, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(&y[i]), cy)));
+        _mm_storeu_ps(outZ + i, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(&z[i]), cz)));
+    }
+#elif WORLD_SIMD_WIDTH == 2
+    const __m128d cx = _mm_set1_pd(camera.x);
+    const __m128d cy = _mm_set1_pd(camera.y);
+    const __m128d cz = _mm_set1_pd(camera.z);
+    for (; i + 2 <= count; i += 2)
+    {
+        // 转换结果在低 64 位（两个 float）
+        _mm_storel_pi((__m64*)(outX + i), _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&x[i]), cx)));
+        _mm_storel_pi((__m64*)(outY + i), _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&y[i]), cy)));
+        _mm_storel_pi((__m64*)(outZ + i), _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&z[i]), cz)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        outX[i] = (float)(x[i] - camera.x);
+        outY[i] = (float)(y[i] - camera.y);
+        outZ[i] = (float)(z[i] - camera.z);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef WORLD_POSITIONS_H
+#define WORLD_POSITIONS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// 双精度世界坐标，按分量分别连续存放（SoA）
+//
+// 太阳系尺度下 float 世界坐标只有约 7 位有效数字，远离原点时顶点会抖动。
+// 世界坐标始终用 double 保存，渲染前一次批量转换为相对相机的 float：
+// 先用 double 相减（相机附近的物体差值很小，没有精度损失），再转成 float，
+// 之后所有变换都在以相机为原点的空间中进行，任何位置附近的精度都一样。
+// 启用 AVX 编译时每次转换 4 个，否则使用 SSE2（2 个）或标量路径。
+class WorldPositions
+{
+public:
+    void resize(size_t count);
+    size_t size() const { return count; }
+
+    void set(size_t index, const glm::dvec3& position)
+    {
+        x[index] = position.x;
+        y[index] = position.y;
+        z[index] = position.z;
+    }
+    glm::dvec3 get(size_t index) const { return glm::dvec3(x[index], y[index], z[index]); }
+
+    // 写出 size() 个相对 camera 的 float 坐标（分量分别写到 outX / outY / outZ）
+    void toCameraRelative(const glm::dvec3& camera, float* outX, float* outY, float* outZ) const;
+
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+private:
+    size_t count = 0;
+};
+
+#endif // WORLD_POSITIONS_H